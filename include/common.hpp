@@ -6,10 +6,13 @@
 #include <nlohmann/json.hpp>
 #include <simgrid/s4u.hpp>
 
+#include <atomic>
 #include <iomanip>
 #include <map>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <ranges>
 #include <ctime>
@@ -18,6 +21,12 @@
 #include <ostream>
 #include <sstream>
 #include <bitset>
+#include <cmath>
+#include <numeric>
+
+#include "dag.hpp"
+#include "kernels.hpp"
+#include "trace.hpp"
 
 enum CommonClockFrequencyType
 {
@@ -45,6 +54,60 @@ enum CommonMapperType
 };
 typedef CommonMapperType mapper_type_t;
 
+// Time model of the simulation mapper (mapper_simulation_engine):
+// - list: execs run to completion in the order next() returns them; every core looks available,
+//   and an exec starts at the availability of its core (list scheduling).
+// - event: discrete-event simulation; next() is invoked at event times (exec finish, data ready),
+//   cores are busy until their exec finishes, and only released execs are ready.
+enum CommonSimulationEngineType
+{
+    COMMON_SIMULATION_ENGINE_LIST,
+    COMMON_SIMULATION_ENGINE_EVENT,
+};
+typedef CommonSimulationEngineType simulation_engine_t;
+
+enum CommonHugePagesType
+{
+    COMMON_HUGE_PAGES_NONE,
+    COMMON_HUGE_PAGES_TRANSPARENT,
+    COMMON_HUGE_PAGES_EXPLICIT,
+};
+typedef CommonHugePagesType huge_pages_type_t;
+
+// Placements whose writes would exceed the memory budget of a NUMA node are:
+// - penalize: charged the time to spill the excess bytes to the nearest other node.
+// - forbid: discarded, unless no node fits (then penalized).
+enum CommonNumaMemoryPolicyType
+{
+    COMMON_NUMA_MEMORY_POLICY_NONE,
+    COMMON_NUMA_MEMORY_POLICY_PENALIZE,
+    COMMON_NUMA_MEMORY_POLICY_FORBID,
+};
+typedef CommonNumaMemoryPolicyType numa_memory_policy_t;
+
+// Source of the per-exec performance counters (mapper_perf_counters), chosen at runtime_initialize:
+// - hardware: perf_event_open PMU events (cycles, instructions, LLC and NUMA node misses, when exposed).
+// - software: perf_event_open software events (e.g., perf_event_paranoid forbids PMU access).
+// - rusage: getrusage and the thread CPU clock (perf_event_open unavailable, e.g., in containers).
+enum CommonPerfCountersType
+{
+    COMMON_PERF_COUNTERS_NONE,
+    COMMON_PERF_COUNTERS_HARDWARE,
+    COMMON_PERF_COUNTERS_SOFTWARE,
+    COMMON_PERF_COUNTERS_RUSAGE,
+};
+typedef CommonPerfCountersType perf_counters_type_t;
+
+// Phases of an exec in which counters are collected.
+enum CommonPhaseType
+{
+    COMMON_PHASE_READ,
+    COMMON_PHASE_COMPUTE,
+    COMMON_PHASE_WRITE,
+    COMMON_PHASES_COUNT,
+};
+typedef CommonPhaseType phase_type_t;
+
 struct thread_locality_s
 {
     int numa_id;
@@ -55,13 +118,83 @@ struct thread_locality_s
 };
 typedef struct thread_locality_s thread_locality_t;
 
-typedef std::unordered_map<std::string, char *> name_to_address_t;
-typedef std::unordered_map<std::string, unsigned int> name_to_count_t;
-typedef std::unordered_map<std::string, std::vector<int>> name_to_numa_ids_t;
-typedef std::unordered_map<std::string, thread_locality_t> name_to_thread_locality_t;
+// Bit i is set when (part of) a data item lives in NUMA node i.
+typedef uint64_t numa_mask_t;
 
 typedef std::tuple<double, double, double> time_range_payload_t;
-typedef std::unordered_map<std::string, time_range_payload_t> name_to_time_range_payload_t;
+
+typedef std::vector<unsigned int> exec_ids_t;
+
+// Trace tables are indexed by the dense exec_id/comm_id assigned at load time.
+// Each slot is written once by the thread executing the exec that owns it.
+typedef std::vector<char *> id_to_address_t;
+typedef std::vector<unsigned int> id_to_count_t;
+
+struct id_to_numa_ids_s
+{
+    std::vector<numa_mask_t> numa_mask;
+    std::vector<uint8_t> recorded;
+};
+typedef struct id_to_numa_ids_s id_to_numa_ids_t;
+
+struct id_to_thread_locality_s
+{
+    std::vector<thread_locality_t> locality;
+    std::vector<uint8_t> recorded;
+};
+typedef struct id_to_thread_locality_s id_to_thread_locality_t;
+
+// Counter values by exec_id and phase: values[(id * COMMON_PHASES_COUNT + phase) * counters_count + counter].
+struct id_to_perf_counters_s
+{
+    size_t counters_count;
+    std::vector<double> values;
+    std::vector<uint8_t> recorded;
+};
+typedef struct id_to_perf_counters_s id_to_perf_counters_t;
+
+// Struct-of-arrays layout of time_range_payload_t.
+struct id_to_time_range_payload_s
+{
+    std::vector<double> start;
+    std::vector<double> end;
+    std::vector<double> payload;
+    std::vector<uint8_t> recorded;
+};
+typedef struct id_to_time_range_payload_s id_to_time_range_payload_t;
+
+// Range of ids stored contiguously (e.g., a row of a CSR adjacency).
+struct id_range_s
+{
+    const unsigned int *first;
+    const unsigned int *last;
+
+    const unsigned int *begin() const { return first; }
+    const unsigned int *end() const { return last; }
+    size_t size() const { return last - first; }
+};
+typedef struct id_range_s id_range_t;
+
+// Workflow structure, fixed after the DAG is loaded.
+// - exec_id is the position of the exec in the dag vector.
+// - comm_id enumerates the comms between execs (root->* and *->end are ignored).
+// - Adjacencies are stored in CSR form: the in-comms of exec_id i are
+//   exec_in_comm_ids[exec_in_offsets[i] .. exec_in_offsets[i + 1]).
+struct workflow_s
+{
+    std::vector<std::string> exec_names;
+    std::vector<double> exec_flops;
+    std::vector<unsigned int> exec_in_offsets;
+    std::vector<unsigned int> exec_in_comm_ids;
+    std::vector<unsigned int> exec_out_offsets;
+    std::vector<unsigned int> exec_out_comm_ids;
+
+    std::vector<std::string> comm_names;
+    std::vector<double> comm_payloads;
+    std::vector<unsigned int> comm_src_exec_ids;
+    std::vector<unsigned int> comm_dst_exec_ids;
+};
+typedef struct workflow_s workflow_t;
 
 typedef simgrid::s4u::Exec simgrid_exec_t;
 typedef std::vector<simgrid_exec_t *> simgrid_execs_t;
@@ -73,6 +206,95 @@ typedef simgrid::s4u::Activity simgrid_activity_t;
 typedef simgrid::s4u::ActivityPtr simgrid_activity_ptr_t;
 
 typedef std::vector<std::vector<double>> distance_matrix_t;
+
+// Clock frequency sampler (dynamic clock_frequency_type).
+// A background thread reads <sysfs_root>/cpu<N>/cpufreq/scaling_cur_freq every interval_ms and
+// stores the (optionally EWMA-smoothed) value per core_id; readers only perform atomic loads.
+struct clock_frequency_sampler_s
+{
+    std::string sysfs_root;
+    unsigned int interval_ms;
+    double ewma_alpha;  // 1.0 disables smoothing.
+
+    std::vector<std::atomic<double>> core_id_to_clock_frequency_hz;
+
+    std::atomic<bool> running;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+typedef struct clock_frequency_sampler_s clock_frequency_sampler_t;
+
+// Topology lookup tables, built once from hwloc at runtime_initialize and read-only afterwards.
+// core_id, numa_id and l3_id are hwloc logical indexes; pu_os_id is the OS index (sched_getcpu()).
+struct topology_tables_s
+{
+    std::vector<int> core_id_to_numa_id;
+    std::vector<int> core_id_to_pu_os_id;   // First PU of the core.
+    std::vector<int> core_id_to_l3_id;      // -1 if the core has no L3 cache.
+    std::vector<int> pu_os_id_to_core_id;   // -1 if there is no PU with that OS index.
+    std::vector<std::vector<int>> numa_id_to_core_ids;
+    std::vector<double> numa_id_to_local_memory_bytes;  // 0 if unknown.
+};
+typedef struct topology_tables_s topology_tables_t;
+
+// NUMA arena for the data items written by the bare-metal mapper.
+// Blocks are bound to one NUMA node with hwloc and, once freed, kept in per-node free lists
+// indexed by size class (block size 2^size_class); they are returned to the OS at runtime_finalize.
+struct numa_arena_s
+{
+    bool enabled;
+    huge_pages_type_t huge_pages_type;
+    std::atomic<bool> huge_pages_unavailable;  // Explicit huge pages could not be mapped; regular pages are used.
+
+    std::vector<std::vector<std::vector<void *>>> numa_id_to_size_class_to_blocks;  // Free blocks.
+    std::unordered_map<void *, std::pair<int, int>> block_to_numa_id_size_class;   // All blocks.
+
+    size_t blocks_allocated;
+    size_t blocks_recycled;
+    pthread_mutex_t mutex;
+};
+typedef struct numa_arena_s numa_arena_t;
+
+// Input prefetcher (bare-metal). Once an exec is assigned, the in-comms worth migrating
+// (see common_comm_id_read_time) are queued, and a background thread moves their pages
+// to the NUMA node of the assigned core while other execs compute.
+// comm_id_to_state: 0 not queued, 1 queued (or migrating), 2 migrated.
+struct prefetcher_s
+{
+    std::vector<std::pair<unsigned int, int>> queue;  // (comm_id, numa_id), FIFO from queue_head.
+    size_t queue_head;
+    std::vector<uint8_t> comm_id_to_state;
+    std::vector<double> comm_id_to_migration_time_us;
+
+    size_t migrations;
+    bool running;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+typedef struct prefetcher_s prefetcher_t;
+
+// Scheduling decisions, measured by the mapper thread with a monotonic clock.
+// A decision is a scheduler.next() call; the schedulers add the (exec, core) pairs and the ready
+// execs they evaluate to the counters of the decision in progress.
+struct scheduler_stats_s
+{
+    std::vector<double> next_times_us;       // One sample per decision.
+    std::vector<double> best_core_times_us;  // One sample per get_best_core_id call.
+    std::vector<double> cores_evaluated;     // One sample per decision.
+    std::vector<double> execs_evaluated;     // One sample per decision.
+
+    double decision_start_time_us;
+    size_t decision_cores_evaluated;
+    size_t decision_execs_evaluated;
+
+    // mapper_charge_decision_time (simulation): decisions run back to back on the mapper, starting at 0,
+    // and an exec cannot start before the decision that scheduled it ends (decision_clock_us).
+    bool charge_decision_time;
+    double decision_clock_us;
+};
+typedef struct scheduler_stats_s scheduler_stats_t;
 typedef std::unordered_map<std::string, std::string> scheduler_params_t;
 
 typedef void *(*mapper_thread_function_t)(void *);
@@ -81,13 +303,20 @@ struct common_s
 {
     // User-defined.
     double flops_per_cycle;
+    std::vector<double> core_id_to_flops_per_cycle;  // Calibrated per core; empty if not calibrated.
+    unsigned int flops_per_cycle_calibration_ms;     // 0 disables the calibration.
     double clock_frequency_hz;
 
     std::vector<double> clock_frequencies_hz;
     clock_frequency_type_t clock_frequency_type;
+    clock_frequency_sampler_t clock_frequency_sampler;
 
     std::string out_file_name;
 
+    // Trace backend (trace_backend); the binary trace is streamed to trace_writer.file_name.
+    trace_writer_t trace_writer;
+    trace_timeline_t trace_timeline;  // Only open if timeline_file_name is set.
+
     // Units are aligned with the reporting units used by Intel Memory Checker.
     // Latency (ns), Bandwidth (GB/s).
     distance_matrix_t distance_lat_ns;
@@ -102,43 +331,87 @@ struct common_s
     mapper_type_t mapper_type;
     hwloc_membind_policy_t mapper_mem_policy_type;
     std::vector<unsigned> mapper_mem_bind_numa_node_ids;
+    bool mapper_thread_pool;
+
+    // Emulation kernels (bare-metal).
+    kernels_isa_t mapper_kernels_isa;
+    kernels_read_pattern_t mapper_read_pattern_type;
+    size_t mapper_read_stride_bytes;
+    kernels_write_pattern_t mapper_write_pattern_type;
+    kernels_compute_pattern_t mapper_compute_pattern_type;
+
+    numa_arena_t mapper_mem_arena;
+
+    // Per-exec performance counters (bare-metal); names follow the order of the values.
+    bool mapper_perf_counters;
+    perf_counters_type_t perf_counters_type;
+    std::vector<std::string> perf_counter_names;
+
+    // Migrate inputs to the NUMA node of the assigned core when cheaper than reading them remotely.
+    bool mapper_prefetch;
+    prefetcher_t mapper_prefetcher;
+
+    // Simulation mapper time model; with the event engine, idle cores are available from simulation_clock_us on.
+    simulation_engine_t mapper_simulation_engine;
+    double simulation_clock_us;
 
     // Runtime system status.
+    scheduler_stats_t scheduler_stats;
     hwloc_topology_t topology;
+    topology_tables_t topology_tables;
 
     size_t threads_checksum;
     unsigned int threads_active;
+    unsigned long threads_completed;  // Completion events; the mapper blocks on threads_cond until it changes.
+    unsigned int threads_failed;      // Threads that could not complete their exec; the mapper stops dispatching.
     pthread_mutex_t threads_mutex;
     pthread_cond_t threads_cond;
 
-    // Counters
-    name_to_count_t execs_active;
-    name_to_count_t reads_active;
-    name_to_count_t writes_active;
-    std::mutex counters_mutex;  // Protects execs_active, reads_active, writes_active
-
-    // Communication mappings
-    name_to_address_t comm_name_to_address;
-    name_to_numa_ids_t comm_name_to_numa_ids_r;
-    name_to_numa_ids_t comm_name_to_numa_ids_w;
-    mutable std::mutex comm_maps_mutex;  // Protects the 3 maps above
-
-    // Execution mappings
-    name_to_thread_locality_t exec_name_to_thread_locality;
-    std::mutex exec_locality_mutex;
+    // NUMA memory (by numa_id). The budget of a node is numa_memory_budget_ratio * capacity (no budget if
+    // the capacity is unknown). Resident bytes are the live data items: added when written, released once read.
+    std::vector<double> numa_id_to_capacity_bytes;
+    double numa_memory_budget_ratio;
+    numa_memory_policy_t numa_memory_policy;  // Scheduler param numa_memory_policy.
+    double numa_memory_high_watermark;        // Scheduler param numa_memory_high_watermark (0 disables).
+    std::vector<double> numa_id_to_resident_bytes;
+    std::vector<double> numa_id_to_peak_resident_bytes;
+    pthread_mutex_t numa_memory_mutex;
+
+    // Workflow structure (names are only resolved for logging and output).
+    workflow_t workflow;
+
+    // Ready-set. exec_id_to_deps_pending counts the in-comms of each exec not completed yet;
+    // an exec is pushed to execs_ready when its counter reaches zero.
+    id_to_count_t exec_id_to_deps_pending;
+    exec_ids_t execs_ready;
+    pthread_mutex_t execs_ready_mutex;
+
+    // Counters (execs_active by exec_id, reads_active and writes_active by comm_id).
+    id_to_count_t execs_active;
+    id_to_count_t reads_active;
+    id_to_count_t writes_active;
+
+    // Communication mappings (by comm_id).
+    id_to_address_t comm_id_to_address;
+    id_to_numa_ids_t comm_id_to_numa_ids_r;
+    id_to_numa_ids_t comm_id_to_numa_ids_w;
+
+    // Execution mappings (by exec_id).
+    std::vector<int> exec_id_to_core_id;  // Assigned core, -1 until the exec is dispatched.
+    id_to_thread_locality_t exec_id_to_thread_locality;
+    id_to_perf_counters_t exec_id_to_perf_counters;
 
     // Timestamp mappings
-    name_to_time_range_payload_t comm_name_to_r_ts_range_payload;
-    name_to_time_range_payload_t comm_name_to_w_ts_range_payload;
-    name_to_time_range_payload_t exec_name_to_c_ts_range_payload;
-    std::mutex timestamp_mutex;  // Protects all timestamp-related maps
+    id_to_time_range_payload_t comm_id_to_r_ts_range_payload;
+    id_to_time_range_payload_t comm_id_to_w_ts_range_payload;
+    id_to_time_range_payload_t exec_id_to_c_ts_range_payload;
 
     // Offset mappings
-    name_to_time_range_payload_t comm_name_to_r_time_offset_payload;
-    name_to_time_range_payload_t comm_name_to_w_time_offset_payload;
-    name_to_time_range_payload_t exec_name_to_c_time_offset_payload;
-    name_to_time_range_payload_t exec_name_to_rcw_time_offset_payload;
-    mutable std::mutex offset_mutex;  // Protects all offset-related maps
+    id_to_time_range_payload_t comm_id_to_r_time_offset_payload;
+    id_to_time_range_payload_t comm_id_to_w_time_offset_payload;
+    id_to_time_range_payload_t exec_id_to_c_time_offset_payload;
+    id_to_time_range_payload_t exec_id_to_rcw_time_offset_payload;
+    id_to_time_range_payload_t comm_id_to_m_time_offset_payload;  // Migrations (mapper_prefetch).
 };
 typedef struct common_s common_t;
 
@@ -146,6 +419,7 @@ struct thread_data_s
 {
     int assigned_core_id;
     common_t *common;
+    unsigned int exec_id;
     simgrid_exec_t *exec;
     mapper_thread_function_t thread_function;
 };
@@ -154,6 +428,7 @@ typedef struct thread_data_s thread_data_t;
 
 /* UTILS */
 double common_get_time_us();
+double common_get_monotonic_time_us();
 std::string common_join(const std::vector<int> &vec, const std::string &delimiter=",");
 std::pair<std::string, std::string> common_split(const std::string &input, std::string delimiter="->");
 std::vector<bool> common_core_avail_mask_to_vect(uint64_t mask, size_t &core_count);
@@ -162,7 +437,26 @@ nlohmann::json common_config_file_read(const std::string& config_path);
 
 /* USER */
 simgrid_execs_t common_dag_read_from_dot(const std::string &dot_file);
-simgrid_execs_t common_dag_get_ready_execs(const simgrid_execs_t &dag);
+
+void common_workflow_initialize(common_t *common, const simgrid_execs_t &dag);
+void common_workflow_initialize_from_dag_file(common_t *common, const dag_file_t &dag);
+void common_workflow_initialize_from_wfcommons(common_t *common, const std::string &file_name, double core_flops_per_second);
+void common_workflow_initialize_from_workflow(common_t *common, const workflow_t &workflow);
+void common_workflow_write_to_dag_file(const common_t *common, const std::string &file_name);
+id_range_t common_exec_id_get_in_comm_ids(const common_t *common, unsigned int exec_id);
+id_range_t common_exec_id_get_out_comm_ids(const common_t *common, unsigned int exec_id);
+
+void common_scheduler_decision_begin(common_t *common);
+double common_scheduler_decision_end(common_t *common);
+
+void common_trace_initialize(common_t *common, trace_backend_t backend, const std::string &file_name);
+void common_trace_finalize(common_t *common);
+void common_timeline_initialize(common_t *common, const std::string &file_name);
+void common_timeline_finalize(common_t *common);
+
+void common_exec_id_set_completed(common_t *common, unsigned int exec_id);
+void common_comm_id_set_ready(common_t *common, unsigned int comm_id);
+exec_ids_t common_execs_ready_take(common_t *common);
 
 clock_frequency_type_t common_clock_frequency_str_to_type(const std::string &type);
 std::string common_clock_frequency_type_to_str(const clock_frequency_type_t &type);
@@ -174,11 +468,24 @@ std::string common_scheduler_param_get(const common_t *common, const std::string
 
 mapper_type_t common_mapper_str_to_type(const std::string &type);
 std::string common_mapper_type_to_str(const mapper_type_t &type);
+simulation_engine_t common_simulation_engine_str_to_type(const std::string &type);
+std::string common_simulation_engine_type_to_str(const simulation_engine_t &type);
 
 hwloc_membind_policy_t common_mapper_mem_policy_str_to_type(const std::string &type);
 std::string common_mapper_mem_policy_type_to_str(const hwloc_membind_policy_t &type);
 
+huge_pages_type_t common_huge_pages_str_to_type(const std::string &type);
+std::string common_huge_pages_type_to_str(const huge_pages_type_t &type);
+
+perf_counters_type_t common_perf_counters_str_to_type(const std::string &type);
+std::string common_perf_counters_type_to_str(const perf_counters_type_t &type);
+std::string common_phase_type_to_str(const phase_type_t &type);
+
+numa_memory_policy_t common_numa_memory_policy_str_to_type(const std::string &type);
+std::string common_numa_memory_policy_type_to_str(const numa_memory_policy_t &type);
+
 distance_matrix_t common_distance_matrix_read_from_txt(const std::string &txt_file);
+void common_distance_matrix_write_to_txt(const distance_matrix_t &matrix, const std::string &txt_file);
 
 std::vector<int> common_core_id_get_avail(const common_t *common);
 void common_core_id_set_avail(common_t *common, unsigned int core_id, bool avail);
@@ -186,12 +493,24 @@ void common_core_id_set_avail(common_t *common, unsigned int core_id, bool avail
 double common_core_id_get_avail_until(const common_t *common, unsigned int core_id);
 void common_core_id_set_avail_until(common_t *common, unsigned int core_id, double duration);
 
-name_to_time_range_payload_t common_comm_name_to_w_time_offset_payload_filter(const common_t *common, const std::string &dst_name);
+numa_mask_t common_numa_ids_to_mask(const std::vector<int> &numa_ids);
+std::vector<int> common_numa_mask_to_ids(numa_mask_t numa_mask);
+int common_numa_mask_first(numa_mask_t numa_mask);
+int common_numa_mask_count(numa_mask_t numa_mask);
+
+void common_numa_memory_initialize(common_t *common);
+double common_numa_id_get_budget_bytes(const common_t *common, int numa_id);
+double common_numa_id_get_resident_bytes(common_t *common, int numa_id);
+double common_numa_memory_get_utilization(common_t *common);
 
 /* USER UTILS */
-double common_earliest_start_time(const common_t *common, const std::string &exec_name, unsigned int core_id);
+double common_earliest_start_time(const common_t *common, unsigned int exec_id, unsigned int core_id);
+double common_makespan(const common_t *common);
+double common_remote_read_bytes(const common_t *common);
 double common_communication_time(const common_t *common, unsigned int src_numa_id, unsigned int dst_numa_id, double payload);
-double common_compute_time(const common_t *common, double flops, double clock_frequency_hz);
+double common_comm_id_read_time(const common_t *common, unsigned int comm_id, unsigned int dst_numa_id, double earliest_start_time_us, double *migration_time_us);
+double common_compute_time(const common_t *common, unsigned int core_id, double flops, double clock_frequency_hz);
+double common_core_id_get_flops_per_cycle(const common_t *common, unsigned int core_id);
 int common_simulation_find_first_available_core_id(const common_t *common);
 
 /* RUNTIME */
@@ -199,31 +518,41 @@ void common_threads_checksum_update(common_t *common, size_t checksum);
 void common_threads_active_increment(common_t *common);
 void common_threads_active_decrement(common_t *common);
 void common_threads_active_wait(common_t *common);
+void common_threads_failed_increment(common_t *common);
+unsigned int common_threads_failed_get(common_t *common);
+unsigned long common_threads_completed_get(common_t *common);
+bool common_threads_completed_wait(common_t *common, unsigned long threads_completed_seen, const struct timespec &deadline);
+struct timespec common_deadline_from_now(time_t timeout_s);
+
+void common_execs_active_increment(common_t *common, unsigned int exec_id);
+void common_reads_active_increment(common_t *common, unsigned int comm_id);
+void common_writes_active_increment(common_t *common, unsigned int comm_id);
 
-void common_execs_active_increment(common_t *common, const std::string &name);
-void common_reads_active_increment(common_t *common, const std::string &name);
-void common_writes_active_increment(common_t *common, const std::string &name);
+void common_comm_id_to_address_create(common_t *common, unsigned int comm_id, char* write_buffer);
+char* common_comm_id_to_address_get(const common_t *common, unsigned int comm_id);
 
-void common_comm_name_to_address_create(common_t *common, const std::string& comm_name, char* write_buffer);
-char* common_comm_name_to_address_get(const common_t *common, const std::string& comm_name);
+void common_comm_id_to_numa_ids_r_create(common_t *common, unsigned int comm_id, const std::vector<int>& memory_bindings);
 
-void common_comm_name_to_numa_ids_r_create(common_t *common, const std::string& comm_name, const std::vector<int>& memory_bindings);
+void common_comm_id_to_numa_ids_w_create(common_t *common, unsigned int comm_id, const std::vector<int>& memory_bindings);
+numa_mask_t common_comm_id_to_numa_ids_w_get(const common_t *common, unsigned int comm_id);
 
-void common_comm_name_to_numa_ids_w_create(common_t *common, const std::string& comm_name, const std::vector<int>& memory_bindings);
-std::vector<int> common_comm_name_to_numa_ids_w_get(const common_t *common, const std::string& comm_name);
+void common_exec_id_to_core_id_create(common_t *common, unsigned int exec_id, int core_id);
+void common_exec_id_to_thread_locality_create(common_t *common, unsigned int exec_id, const thread_locality_t& locality);
+void common_exec_id_to_perf_counters_create(common_t *common, unsigned int exec_id, phase_type_t phase, const std::vector<double>& values);
 
-void common_exec_name_to_thread_locality_create(common_t *common, const std::string& exec_name,const thread_locality_t& locality);
+void common_comm_id_to_r_ts_range_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload);
+void common_comm_id_to_w_ts_range_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload);
+void common_exec_id_to_c_ts_range_payload_create(common_t *common, unsigned int exec_id, const time_range_payload_t& time_range_payload);
 
-void common_comm_name_to_r_ts_range_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload);
-void common_comm_name_to_w_ts_range_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload);
-void common_exec_name_to_c_ts_range_payload_create(common_t *common, const std::string& exec_name, const time_range_payload_t& time_range_payload);
+void common_comm_id_to_r_time_offset_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload);
+void common_comm_id_to_w_time_offset_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload);
+time_range_payload_t common_comm_id_to_w_time_offset_payload_get(const common_t *common, unsigned int comm_id);
+void common_exec_id_to_c_time_offset_payload_create(common_t *common, unsigned int exec_id, const time_range_payload_t& time_range_payload);
 
-void common_comm_name_to_r_time_offset_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload);
-void common_comm_name_to_w_time_offset_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload);
-void common_exec_name_to_c_time_offset_payload_create(common_t *common, const std::string& exec_name, const time_range_payload_t& time_range_payload);
+void common_exec_id_to_rcw_time_offset_payload_create(common_t *common, unsigned int exec_id, const time_range_payload_t& time_range_payload);
+time_range_payload_t common_exec_id_to_rcw_time_offset_payload_get(const common_t *common, unsigned int exec_id);
 
-void common_exec_name_to_rcw_time_offset_payload_create(common_t *common, const std::string& exec_name, const time_range_payload_t& time_range_payload);
-time_range_payload_t common_exec_name_to_rcw_time_offset_payload_get(const common_t *common, const std::string& exec_name);
+void common_comm_id_to_m_time_offset_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload);
 
 /* OUTPUT */
 void common_print_common_structure(const common_t *common, int indent);
@@ -231,10 +560,13 @@ void common_print_user(const common_t *common, std::ostream &out, int indent);
 void common_print_distance_matrix(const distance_matrix_t &matrix, const std::string &key, std::ostream &out, int indent);
 void common_print_workflow(const common_t *common, std::ostream &out, int indent);
 void common_print_runtime(const common_t *common, std::ostream &out, int indent);
+void common_print_scheduler_stats(const common_t *common, std::ostream &out, int indent);
+void common_print_stats(const std::vector<double> &samples, const std::string &key, std::ostream &out, int indent);
 void common_print_trace(const common_t *common, std::ostream &out, int indent);
-void common_print_name_to_thread_locality(const name_to_thread_locality_t &mapping, std::ostream &out, int indent);
-void common_print_name_to_numa_ids(const name_to_numa_ids_t &mapping, const std::string header, std::ostream &out, int indent);
-void common_print_name_to_time_range_payload(const name_to_time_range_payload_t &mapping, const std::string &header, std::ostream &out, int indent);
+void common_print_id_to_thread_locality(const std::vector<std::string> &names, const id_to_thread_locality_t &mapping, std::ostream &out, int indent);
+void common_print_id_to_perf_counters(const common_t *common, const std::vector<std::string> &names, const id_to_perf_counters_t &mapping, std::ostream &out, int indent);
+void common_print_id_to_numa_ids(const std::vector<std::string> &names, const id_to_numa_ids_t &mapping, const std::string header, std::ostream &out, int indent);
+void common_print_id_to_time_range_payload(const std::vector<std::string> &names, const id_to_time_range_payload_t &mapping, const std::string &header, std::ostream &out, int indent);
 
 /* OUTPUT UTILS */
-size_t common_name_to_count_get(const name_to_count_t &mapping);
+size_t common_id_to_count_get(const id_to_count_t &mapping);
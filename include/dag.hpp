@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary DAG (dag_file with the DAG_FILE_EXTENSION extension): the workflow tables in CSR form,
+// mapped read-only and copied into the workflow without any parsing. nflows --convert-dag writes
+// it from a DOT file, with the same exec_ids and comm_ids as the DOT reader.
+//
+// File layout (counts from the header):
+//   header
+//   exec_flops         double[execs_count]
+//   comm_payloads      double[comms_count]
+//   exec_name_offsets  uint64_t[execs_count + 1]   (into names)
+//   comm_name_offsets  uint64_t[comms_count + 1]   (into names)
+//   exec_out_offsets   uint32_t[execs_count + 1]   (out-comms of exec_id i: [exec_out_offsets[i], exec_out_offsets[i + 1]))
+//   comm_dst_exec_ids  uint32_t[comms_count]
+//   names              char[names_bytes]           (not null-terminated)
+// comm_ids are numbered by source exec, so the out-comm ids of an exec are its out range itself.
+struct dag_header_s
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved0;
+    uint64_t execs_count;
+    uint64_t comms_count;
+    uint64_t names_bytes;
+    uint64_t reserved[3];
+};
+typedef struct dag_header_s dag_header_t;
+
+static_assert(sizeof(dag_header_t) == 64, "dag_header_t must be 64 bytes.");
+
+#define DAG_MAGIC "NFLOWDAG"
+#define DAG_VERSION 1
+#define DAG_FILE_EXTENSION ".nfdag"
+
+struct dag_file_s
+{
+    std::string file_name;
+
+    int fd;
+    const char *base;
+    size_t size;
+
+    const dag_header_t *header;
+    const double *exec_flops;
+    const double *comm_payloads;
+    const uint64_t *exec_name_offsets;
+    const uint64_t *comm_name_offsets;
+    const uint32_t *exec_out_offsets;
+    const uint32_t *comm_dst_exec_ids;
+    const char *names;
+};
+typedef struct dag_file_s dag_file_t;
+
+bool dag_file_is_binary(const std::string &file_name);
+
+void dag_open(dag_file_t &dag, const std::string &file_name);
+void dag_close(dag_file_t &dag);
+
+std::string dag_exec_name(const dag_file_t &dag, size_t exec_id);
+std::string dag_comm_name(const dag_file_t &dag, size_t comm_id);
+
+void dag_write(const std::string &file_name, const std::vector<std::string> &exec_names, const std::vector<double> &exec_flops,
+    const std::vector<unsigned int> &exec_out_offsets, const std::vector<unsigned int> &comm_dst_exec_ids,
+    const std::vector<std::string> &comm_names, const std::vector<double> &comm_payloads);
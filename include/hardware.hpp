@@ -1,10 +1,49 @@
+#pragma once
+
 #include <sys/resource.h> // For getrusage
+#include <sys/mman.h> // For mmap/madvise (huge pages)
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h> // For perf_event_open
+
+#include <numeric>
+#include <random>
 
 #include "common.hpp"
 
+void hardware_hwloc_topology_tables_initialize(common_t *common);
+
 int hardware_hwloc_core_id_get_by_pu_id(const common_t *common, int os_pu_id);
+int hardware_hwloc_pu_id_get_by_core_id(const common_t *common, int hwloc_core_id);
+int hardware_hwloc_l3_id_get_by_core_id(const common_t *common, int hwloc_core_id);
+const std::vector<int> &hardware_hwloc_core_ids_get_by_numa_id(const common_t *common, int hwloc_numa_id);
 double hardware_hwloc_core_id_get_clock_frequency(const common_t *common, int hwloc_core_id);
 double hardware_hwloc_core_id_get_dynamic_clock_frequency(const common_t *common, int hwloc_core_id);
+double hardware_sysfs_core_id_read_clock_frequency(const common_t *common, int hwloc_core_id);
+
+void hardware_clock_frequency_sampler_start(common_t *common);
+void hardware_clock_frequency_sampler_stop(common_t *common);
+
+void hardware_flops_per_cycle_calibrate(common_t *common);
+
+void hardware_numa_distances_calibrate(common_t *common, size_t buffer_bytes, distance_matrix_t &lat_ns, distance_matrix_t &bw_gbps);
+bool hardware_hwloc_distance_matrices_from_slit(const common_t *common, double local_latency_ns, double local_bandwidth_gbps,
+    distance_matrix_t &lat_ns, distance_matrix_t &bw_gbps);
+
+void hardware_numa_arena_initialize(common_t *common);
+int hardware_numa_arena_numa_id_get(const common_t *common, unsigned int comm_id, int core_id);
+char *hardware_numa_arena_alloc(common_t *common, size_t size, int numa_id);
+void hardware_numa_arena_free(common_t *common, char *address);
+void hardware_numa_arena_finalize(common_t *common);
+
+void hardware_perf_counters_initialize(common_t *common);
+void hardware_perf_counters_sample(const common_t *common, std::vector<double> &values);
+void hardware_perf_counters_record(common_t *common, unsigned int exec_id, phase_type_t phase, std::vector<double> &values);
+
+void hardware_prefetcher_start(common_t *common);
+void hardware_prefetcher_submit(common_t *common, unsigned int comm_id, int numa_id);
+double hardware_prefetcher_wait(common_t *common, unsigned int comm_id, double *migration_time_us);
+void hardware_prefetcher_stop(common_t *common);
 
 int hardware_hwloc_numa_id_get_by_core_id(const common_t *common, int hwloc_core_id);
 std::vector<int> hardware_hwloc_numa_id_get_by_address(const common_t *common, char *address, size_t size);
@@ -15,3 +54,32 @@ hwloc_membind_policy_t hardware_hwloc_thread_mem_policy_get_from_os(const common
 thread_locality_t hardware_hwloc_thread_get_locality_from_os(const common_t *common);
 
 void hardware_hwloc_thread_bind_to_core_id(thread_data_t *data);
+
+// Long-lived worker pinned to a core. Its stack, thread_data_t and mailbox are allocated
+// on the NUMA node of the core. The mailbox holds at most one task, since a core is
+// not available again until its worker finishes the current task.
+struct hardware_worker_s
+{
+    common_t *common;
+    pthread_t thread;
+
+    void *stack;
+    size_t stack_size;
+    thread_data_t *data;
+
+    // Mailbox.
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool pending;
+    bool stop;
+    unsigned int pending_exec_id;
+    simgrid_exec_t *pending_exec;
+};
+typedef struct hardware_worker_s hardware_worker_t;
+
+// Workers indexed by core_id (nullptr for unavailable cores).
+typedef std::vector<hardware_worker_t *> hardware_worker_pool_t;
+
+void hardware_worker_pool_start(common_t *common, hardware_worker_pool_t &pool, mapper_thread_function_t thread_function);
+void hardware_worker_pool_submit(hardware_worker_pool_t &pool, int core_id, unsigned int exec_id, simgrid_exec_t *exec);
+void hardware_worker_pool_stop(hardware_worker_pool_t &pool);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Emulation kernels used by the bare-metal mapper to move and compute on task data.
+// The instruction set is detected once with CPUID; every kernel has a scalar fallback.
+
+enum KernelsIsaType
+{
+    KERNELS_ISA_SCALAR,
+    KERNELS_ISA_SSE2,
+    KERNELS_ISA_AVX2,
+    KERNELS_ISA_AVX512,
+};
+typedef KernelsIsaType kernels_isa_t;
+
+// Order in which a read kernel visits the cache lines of a buffer.
+// - sequential: ascending addresses (hardware prefetchers at their best).
+// - strided: one line every stride_bytes, repeated with increasing offsets until every line is read.
+// - gather: every line once, in a pseudo-random order (independent loads).
+// - pointer-chase: the address of each load depends on the value of the previous one (dependent loads).
+enum KernelsReadPatternType
+{
+    KERNELS_READ_SEQUENTIAL,
+    KERNELS_READ_STRIDED,
+    KERNELS_READ_GATHER,
+    KERNELS_READ_POINTER_CHASE,
+};
+typedef KernelsReadPatternType kernels_read_pattern_t;
+
+// - temporal: regular stores (memset); written lines stay in the writer's caches.
+// - non-temporal: streaming stores that bypass the caches and go straight to memory.
+enum KernelsWritePatternType
+{
+    KERNELS_WRITE_TEMPORAL,
+    KERNELS_WRITE_NON_TEMPORAL,
+};
+typedef KernelsWritePatternType kernels_write_pattern_t;
+
+// Flops are counted as in common_compute_time (one FMA = 2 flops).
+// - fma: independent (vector) FMA accumulators kept in registers; compute bound.
+// - triad: STREAM triad a[i] = b[i] + s * c[i] (2 flops and 24 bytes per element); memory bound.
+// - mixed: triad followed by KERNELS_MIXED_FMAS dependent FMAs per element (14 flops per 24 bytes).
+enum KernelsComputePatternType
+{
+    KERNELS_COMPUTE_FMA,
+    KERNELS_COMPUTE_TRIAD,
+    KERNELS_COMPUTE_MIXED,
+};
+typedef KernelsComputePatternType kernels_compute_pattern_t;
+
+// Compute kernel state; the triad arrays are allocated (and first touched) by
+// kernels_compute_initialize, so they are local to the calling thread and not timed.
+struct kernels_compute_s
+{
+    kernels_isa_t isa;
+    kernels_compute_pattern_t pattern;
+
+    double *a;
+    double *b;
+    double *c;
+    size_t elements;
+};
+typedef struct kernels_compute_s kernels_compute_t;
+
+#define KERNELS_CACHE_LINE_BYTES 64
+#define KERNELS_TRIAD_MAX_ELEMENTS (2 * 1024 * 1024)  // 16 MB per array.
+#define KERNELS_MIXED_FMAS 6
+
+kernels_isa_t kernels_isa_detect();
+kernels_isa_t kernels_isa_str_to_type(const std::string &type);
+std::string kernels_isa_type_to_str(const kernels_isa_t &type);
+
+kernels_read_pattern_t kernels_read_pattern_str_to_type(const std::string &type);
+std::string kernels_read_pattern_type_to_str(const kernels_read_pattern_t &type);
+
+kernels_write_pattern_t kernels_write_pattern_str_to_type(const std::string &type);
+std::string kernels_write_pattern_type_to_str(const kernels_write_pattern_t &type);
+
+kernels_compute_pattern_t kernels_compute_pattern_str_to_type(const std::string &type);
+std::string kernels_compute_pattern_type_to_str(const kernels_compute_pattern_t &type);
+
+size_t kernels_read(kernels_isa_t isa, kernels_read_pattern_t pattern, const char *buffer, size_t bytes, size_t stride_bytes);
+void kernels_write(kernels_isa_t isa, kernels_write_pattern_t pattern, char *buffer, size_t bytes);
+
+void kernels_compute_initialize(kernels_compute_t &compute, kernels_isa_t isa, kernels_compute_pattern_t pattern, double flops);
+double kernels_compute(const kernels_compute_t &compute, double flops);
+void kernels_compute_finalize(kernels_compute_t &compute);
@@ -6,8 +6,13 @@
 
 class Mapper_Bare_Metal : public Mapper_Base
 {
+  private:
+    hardware_worker_pool_t worker_pool;
+
+    void prefetch(unsigned int exec_id, int core_id);
+
   public:
-    Mapper_Bare_Metal(common_t *common, scheduler_t &scheduler);
+    Mapper_Bare_Metal(common_t *common, scheduler_t &scheduler, simgrid_execs_t &dag);
     ~Mapper_Bare_Metal();
 
     void start() override;
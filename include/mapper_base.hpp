@@ -16,15 +16,17 @@ class Mapper_Base
     simgrid_host_t *dummy_host;
     simgrid_netzone_t *dummy_net_zone;
     scheduler_t &scheduler;
+    simgrid_execs_t &dag;
 
   public:
-    Mapper_Base(common_t *common, scheduler_t &scheduler);
+    Mapper_Base(common_t *common, scheduler_t &scheduler, simgrid_execs_t &dag);
     virtual ~Mapper_Base() = default;
 
     // thread function to be executed.
     void *(*thread_func_ptr)(void *);
 
     void set_thread_func_ptr(void *(*func)(void *));
+    bool has_simgrid_execs() const;
 
     virtual void start() = 0;
 };
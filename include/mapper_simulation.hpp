@@ -4,10 +4,55 @@
 
 #include <xbt/log.h>
 
+#include <queue>
+#include <vector>
+
+// Events of the event engine (mapper_simulation_engine "event"):
+// - exec finish: the core of the exec becomes available.
+// - data ready: a comm can be read, its destination exec loses one pending dependency.
+enum MapperSimulationEventType
+{
+    MAPPER_SIMULATION_EVENT_EXEC_FINISH,
+    MAPPER_SIMULATION_EVENT_DATA_READY,
+};
+typedef MapperSimulationEventType mapper_simulation_event_type_t;
+
+struct mapper_simulation_event_s
+{
+    double time_us;
+    unsigned long seq;  // Insertion order; events at the same time are processed first in, first out.
+    mapper_simulation_event_type_t type;
+    unsigned int id;    // core_id (exec finish) or comm_id (data ready).
+};
+typedef struct mapper_simulation_event_s mapper_simulation_event_t;
+
+// Orders the priority queue by (time_us, seq), earliest on top.
+struct mapper_simulation_event_later_s
+{
+    bool operator()(const mapper_simulation_event_t &a, const mapper_simulation_event_t &b) const
+    {
+        return a.time_us > b.time_us || (a.time_us == b.time_us && a.seq > b.seq);
+    }
+};
+typedef struct mapper_simulation_event_later_s mapper_simulation_event_later_t;
+
+typedef std::priority_queue<mapper_simulation_event_t, std::vector<mapper_simulation_event_t>, mapper_simulation_event_later_t> mapper_simulation_events_t;
+
 class Mapper_Simulation : public Mapper_Base
 {
+  private:
+    mapper_simulation_events_t events;
+    unsigned long events_seq;
+
+    void dispatch(int exec_id, int core_id);
+    void event_push(double time_us, mapper_simulation_event_type_t type, unsigned int id);
+    void events_process_until(double time_us);
+
+    void start_list();
+    void start_event();
+
   public:
-    Mapper_Simulation(common_t *common, scheduler_t &scheduler);
+    Mapper_Simulation(common_t *common, scheduler_t &scheduler, simgrid_execs_t &dag);
     ~Mapper_Simulation();
 
     void start() override;
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <vector>
 #include <memory>
+#include <thread>
 #include <exception> // For std::exception
 #include <cstdlib>   // For EXIT_FAILURE
 #include <nlohmann/json.hpp>
@@ -19,5 +20,8 @@
 
 void runtime_start(mapper_t **mapper);
 void runtime_stop(common_t **common);
+void runtime_calibrate(common_t **common, const std::string &latency_file, const std::string &bandwidth_file, size_t buffer_mib);
+void runtime_convert_dag(common_t **common, simgrid_execs_t **dag, const std::string &dot_file, const std::string &dag_file);
+void runtime_sweep(common_t **common, simgrid_execs_t **dag, const std::string &sweep_path);
 void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **scheduler, mapper_t **mapper, const std::string &config_path);
 void runtime_finalize(common_t **common, simgrid_execs_t **dag, scheduler_t **scheduler, mapper_t **mapper);
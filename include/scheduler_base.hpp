@@ -6,19 +6,34 @@
 class Base_Scheduler
 {
   protected:
-    const common_t *common;
+    common_t *common;
     simgrid_execs_t &dag;
 
-    virtual std::tuple<int, double> get_best_core_id(const simgrid_exec_t *exec) = 0;
+    // Ready and not yet assigned execs, in ascending exec_id order.
+    exec_ids_t ready_exec_ids;
+    size_t unassigned_execs_count;
+
+    void ready_exec_ids_update();
+    void ready_exec_id_set_assigned(unsigned int exec_id);
+
+    virtual std::tuple<int, double> get_best_core_id(unsigned int exec_id) = 0;
+    std::tuple<int, double> select_best_core_id(unsigned int exec_id);  // Timed get_best_core_id.
+
+    // Memory-aware scheduling (numa_memory_policy, numa_memory_high_watermark).
+    double get_memory_delta(unsigned int exec_id, int numa_id);
+    double get_memory_penalty(int numa_id, double memory_delta_bytes, numa_memory_policy_t policy);
+    double get_memory_release(unsigned int exec_id);
+    bool memory_pressure_high();
 
   public:
-    Base_Scheduler(const common_t *common, simgrid_execs_t &dag);
+    Base_Scheduler(common_t *common, simgrid_execs_t &dag);
     virtual ~Base_Scheduler() = default; // Ensures proper destructor chaining
 
     virtual void initialize() = 0;
 
     virtual bool has_next();
-    virtual std::tuple<simgrid_exec_t *, int, double> next() = 0;
+    // Returns {exec_id, core_id, estimated_finish_time}; exec_id is -1 when no exec is ready.
+    virtual std::tuple<int, int, double> next() = 0;
 };
 
 typedef Base_Scheduler scheduler_t;
@@ -4,12 +4,51 @@
 #include "hardware.hpp"
 #include "scheduler_base.hpp"
 
+// Core-independent terms of the finish time of an exec.
+// Read and write times only depend on the NUMA node of the core (indexed by numa_id);
+// with mapper_prefetch, read times also depend on the start time and are evaluated per core.
+struct eft_exec_costs_s
+{
+    unsigned int exec_id;
+    double max_pred_finish_time_us;
+    double flops;
+    std::vector<double> numa_id_to_read_time_us;
+    std::vector<double> numa_id_to_write_time_us;
+};
+typedef struct eft_exec_costs_s eft_exec_costs_t;
+
+// Available cores grouped by NUMA node (struct-of-arrays). The cores of numa_id i
+// are [numa_offsets[i], numa_offsets[i + 1]), in ascending core_id order.
+struct eft_cores_s
+{
+    std::vector<unsigned int> numa_offsets;
+    std::vector<int> core_ids;
+    std::vector<double> avail_until_us;
+    std::vector<double> clock_frequency_hz;
+    std::vector<double> flops_per_cycle;
+};
+typedef struct eft_cores_s eft_cores_t;
+
 class EFT_Scheduler : public Base_Scheduler
 {
+  private:
+    // Scratch buffers reused by get_best_core_id.
+    eft_exec_costs_t exec_costs;
+    eft_cores_t avail_cores;
+    std::vector<double> finish_times_us;
+    std::vector<double> numa_id_to_memory_penalty_us;
+
+    void get_avail_cores(eft_cores_t &cores);
+    void get_memory_penalties(unsigned int exec_id, const eft_cores_t &cores, std::vector<double> &penalties);
+
   protected:
-    std::tuple<int, double> get_best_core_id(const simgrid_exec_t *exec) override;
+    std::tuple<int, double> get_best_core_id(unsigned int exec_id) override;
+
+    void get_exec_costs(unsigned int exec_id, eft_exec_costs_t &costs);
+    double get_read_time(const eft_exec_costs_t &costs, int numa_id, double earliest_start_time_us);
+    double get_finish_time(const eft_exec_costs_t &costs, int core_id);
 
   public:
-    EFT_Scheduler(const common_t *common, simgrid_execs_t &dag);
+    EFT_Scheduler(common_t *common, simgrid_execs_t &dag);
     ~EFT_Scheduler();
 };
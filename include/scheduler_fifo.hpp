@@ -9,21 +9,21 @@
 class FIFO_Scheduler : public Base_Scheduler
 {
   private:
-    std::deque<simgrid_exec_t*> queue;
+    std::deque<unsigned int> queue;
 
-    double compute_data_locality_score(simgrid_exec_t *task);
-    std::unordered_map<std::string, double> get_data_locality_scores(simgrid_execs_t &execs);
+    double compute_data_locality_score(unsigned int exec_id);
+    std::unordered_map<unsigned int, double> get_data_locality_scores(const exec_ids_t &exec_ids);
 
   protected:
-    std::tuple<int, double> get_best_core_id(const simgrid_exec_t *exec) override;
+    std::tuple<int, double> get_best_core_id(unsigned int exec_id) override;
 
   public:
-    FIFO_Scheduler(const common_t *common, simgrid_execs_t &dag);
+    FIFO_Scheduler(common_t *common, simgrid_execs_t &dag);
     ~FIFO_Scheduler();
 
     void initialize() override;
 
-    std::tuple<simgrid_exec_t *, int, double> next() override;
+    std::tuple<int, int, double> next() override;
 };
 
 typedef FIFO_Scheduler fifo_scheduler_t;
@@ -2,6 +2,8 @@
 
 #include <xbt/log.h>
 
+#include <numeric>
+
 #include "common.hpp"
 #include "hardware.hpp"
 #include "scheduler_eft.hpp"
@@ -9,20 +11,30 @@
 class HEFT_Scheduler : public EFT_Scheduler
 {
   private:
-    std::unordered_map<std::string, double> upward_ranks;
-    std::unordered_map<std::string, double> name_to_cost_seconds;
+    std::vector<double> upward_ranks;
+    std::vector<double> exec_id_to_cost_seconds;
+    std::vector<double> comm_id_to_cost_seconds;
+
+    // Integer priority of each exec (0 is the highest upward rank), and its inverse.
+    std::vector<unsigned int> exec_id_to_rank_order;
+    std::vector<unsigned int> rank_order_to_exec_id;
+
+    // Min-heap of rank orders of the ready execs.
+    std::vector<unsigned int> ready_heap;
 
     void initialize_compute_and_communication_costs();
-    double compute_upward_rank(simgrid_exec_t *task);
+    double compute_upward_rank(unsigned int exec_id);
     void initialize_all_upward_ranks();
+    void initialize_rank_orders();
+    void ready_heap_push(const exec_ids_t &exec_ids);
 
   public:
-    HEFT_Scheduler(const common_t *common, simgrid_execs_t &dag);
+    HEFT_Scheduler(common_t *common, simgrid_execs_t &dag);
     ~HEFT_Scheduler();
 
     void initialize() override;
 
-    std::tuple<simgrid_exec_t *, int, double> next() override;
+    std::tuple<int, int, double> next() override;
 };
 
 typedef HEFT_Scheduler heft_scheduler_t;
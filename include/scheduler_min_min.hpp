@@ -2,19 +2,42 @@
 
 #include <xbt/log.h>
 
+#include <numeric>
+
 #include "common.hpp"
 #include "hardware.hpp"
 #include "scheduler_eft.hpp"
 
 class MIN_MIN_Scheduler : public EFT_Scheduler
 {
+  private:
+    // Ready exec x core_id finish-time matrix (row-major, one row per ready exec).
+    // Unavailable cores hold +inf.
+    size_t cores_count;
+    exec_ids_t row_exec_ids;
+    std::vector<eft_exec_costs_t> row_exec_costs;
+    std::vector<double> finish_times;
+
+    // Per-row minimum (best_core_id is -1 if there are no available cores).
+    std::vector<int> row_best_core_ids;
+    std::vector<double> row_best_finish_times;
+
+    // Core state used to fill the matrix, to detect the columns to recompute.
+    std::vector<bool> core_avail_snapshot;
+    std::vector<double> core_avail_until_snapshot;
+
+    std::vector<int> get_dirty_core_ids();
+    void row_update(size_t row, const std::vector<int> &core_ids);
+    void row_append(unsigned int exec_id);
+    void row_remove(size_t row);
+
   public:
-    MIN_MIN_Scheduler(const common_t *common, simgrid_execs_t &dag);
+    MIN_MIN_Scheduler(common_t *common, simgrid_execs_t &dag);
     ~MIN_MIN_Scheduler();
 
     void initialize() override;
 
-    std::tuple<simgrid_exec_t *, int, double> next() override;
+    std::tuple<int, int, double> next() override;
 };
 
 typedef MIN_MIN_Scheduler min_min_scheduler_t;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Trace backends.
+// - yaml: trace tables are kept in memory (by exec_id/comm_id) and printed with the output file at the end.
+// - binary: every trace entry is appended as a fixed-size record to a memory-mapped file while the run
+//   progresses; only the tables the schedulers read back are kept in memory. tools/trace_to_yaml.py
+//   converts the file to the trace section of the yaml backend.
+enum TraceBackendType
+{
+    TRACE_BACKEND_YAML,
+    TRACE_BACKEND_BINARY,
+};
+typedef TraceBackendType trace_backend_t;
+
+// One type per trace table, in output order.
+enum TraceRecordType
+{
+    TRACE_RECORD_THREAD_LOCALITY,   // numa_id, core_id; start/end/payload: voluntary_cs/involuntary_cs/core_migrations.
+    TRACE_RECORD_PERF_COUNTER,      // phase, counter (index in the counter names); payload: value.
+    TRACE_RECORD_NUMA_WRITE,        // numa_mask.
+    TRACE_RECORD_NUMA_READ,         // numa_mask.
+    TRACE_RECORD_READ_TIMESTAMP,
+    TRACE_RECORD_WRITE_TIMESTAMP,
+    TRACE_RECORD_COMPUTE_TIMESTAMP,
+    TRACE_RECORD_READ_OFFSET,
+    TRACE_RECORD_WRITE_OFFSET,
+    TRACE_RECORD_MIGRATION_OFFSET,
+    TRACE_RECORD_COMPUTE_OFFSET,
+    TRACE_RECORD_TOTAL_OFFSET,
+    TRACE_RECORDS_COUNT,
+};
+typedef TraceRecordType trace_record_type_t;
+
+// id is an exec_id or a comm_id depending on the type. Unused fields are zero (core_id/numa_id -1).
+struct trace_record_s
+{
+    uint8_t type;
+    uint8_t phase;
+    uint16_t counter;
+    uint32_t id;
+    double start;
+    double end;
+    double payload;
+    uint64_t numa_mask;
+    int32_t core_id;
+    int32_t numa_id;
+};
+typedef struct trace_record_s trace_record_t;
+
+static_assert(sizeof(trace_record_t) == 48, "trace_record_t must be 48 bytes.");
+
+// File layout: header | records_count records | string table.
+// The string table holds execs_count exec names, comms_count comm names, counters_count counter names
+// and the perf counters source, each as a uint32_t length followed by the characters.
+// records_count and strings_offset are written by trace_close; both are 0 if the run did not finish.
+struct trace_header_s
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_bytes;
+    uint64_t records_count;
+    uint64_t strings_offset;
+    uint32_t execs_count;
+    uint32_t comms_count;
+    uint32_t counters_count;
+    uint32_t reserved[5];
+};
+typedef struct trace_header_s trace_header_t;
+
+static_assert(sizeof(trace_header_t) == 64, "trace_header_t must be 64 bytes.");
+
+#define TRACE_MAGIC "NFLOWTRC"
+#define TRACE_VERSION 1
+
+// Records are reserved with an atomic counter; appenders hold the lock shared, and the file
+// is only grown (and remapped) with the lock held exclusively.
+struct trace_writer_s
+{
+    trace_backend_t backend;
+    std::string file_name;
+
+    int fd;
+    char *base;
+    size_t capacity_records;
+    std::atomic<size_t> records_count;
+    pthread_rwlock_t lock;
+};
+typedef struct trace_writer_s trace_writer_t;
+
+// Timeline (timeline_file_name): Chrome Trace Event JSON, loadable in Perfetto or chrome://tracing.
+// Events are streamed as they are recorded: one process per NUMA node, one thread (track) per core,
+// one slice per read, compute and write, and a flow arrow per comm from the write to the read slice.
+struct trace_timeline_s
+{
+    FILE *file;
+    size_t events_count;
+    pthread_mutex_t mutex;
+};
+typedef struct trace_timeline_s trace_timeline_t;
+
+trace_backend_t trace_backend_str_to_type(const std::string &type);
+std::string trace_backend_type_to_str(const trace_backend_t &type);
+
+void trace_open(trace_writer_t &writer, const std::string &file_name, size_t capacity_records);
+void trace_append(trace_writer_t &writer, const trace_record_t &record);
+void trace_close(trace_writer_t &writer, const std::vector<std::string> &exec_names, const std::vector<std::string> &comm_names,
+    const std::vector<std::string> &counter_names, const std::string &counters_source);
+
+void trace_timeline_open(trace_timeline_t &timeline, const std::string &file_name);
+void trace_timeline_track(trace_timeline_t &timeline, int numa_id, int core_id);
+void trace_timeline_slice(trace_timeline_t &timeline, const char *category, const std::string &name, int numa_id, int core_id,
+    double start_us, double end_us, const std::string &args);
+void trace_timeline_flow(trace_timeline_t &timeline, bool flow_start, unsigned int flow_id, const std::string &name, int numa_id, int core_id,
+    double time_us);
+void trace_timeline_close(trace_timeline_t &timeline);
@@ -10,6 +10,14 @@ double common_get_time_us()
     return (double)tv.tv_sec * 1000000 + tv.tv_usec;
 }
 
+// Elapsed-time measurements (not affected by wall clock adjustments).
+double common_get_monotonic_time_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000 + (double)ts.tv_nsec / 1000;
+}
+
 std::string common_join(const std::vector<int> &vec, const std::string &delimiter)
 {
     std::ostringstream oss;
@@ -127,14 +135,494 @@ simgrid_execs_t common_dag_read_from_dot(const std::string &file_name)
     return execs;
 }
 
-simgrid_execs_t common_dag_get_ready_execs(const simgrid_execs_t &execs)
+template <typename T>
+static void common_table_resize(std::vector<T> &table, size_t size)
+{
+    table.assign(size, T());
+}
+
+static void common_table_resize(id_to_time_range_payload_t &table, size_t size)
+{
+    table.start.assign(size, 0.0);
+    table.end.assign(size, 0.0);
+    table.payload.assign(size, 0.0);
+    table.recorded.assign(size, 0);
+}
+
+static void common_table_resize(id_to_numa_ids_t &table, size_t size)
+{
+    table.numa_mask.assign(size, 0);
+    table.recorded.assign(size, 0);
+}
+
+static void common_table_resize(id_to_thread_locality_t &table, size_t size)
+{
+    table.locality.assign(size, thread_locality_t{});
+    table.recorded.assign(size, 0);
+}
+
+// Release the memory of a table that is no longer recorded.
+template <typename T>
+static void common_table_release(T &table)
+{
+    table = T();
+}
+
+static void common_workflow_tables_initialize(common_t *common);
+
+void common_workflow_initialize(common_t *common, const simgrid_execs_t &dag)
+{
+    workflow_t &workflow = common->workflow;
+    size_t execs_count = dag.size();
+
+    // 1. Assign exec ids (position in the dag).
+    std::unordered_map<const simgrid_activity_t *, unsigned int> exec_to_id;
+    exec_to_id.reserve(execs_count);
+
+    workflow.exec_names.resize(execs_count);
+    workflow.exec_flops.resize(execs_count);
+
+    for (unsigned int exec_id = 0; exec_id < execs_count; ++exec_id)
+    {
+        exec_to_id[dag[exec_id]] = exec_id;
+        workflow.exec_names[exec_id] = dag[exec_id]->get_name();
+        workflow.exec_flops[exec_id] = dag[exec_id]->get_remaining();
+    }
+
+    // 2. Assign comm ids following the dag order, and build the out-adjacency.
+    // Comms to execs outside the dag (i.e., task_i->end) are ignored.
+    workflow.exec_out_offsets.assign(1, 0);
+
+    for (unsigned int exec_id = 0; exec_id < execs_count; ++exec_id)
+    {
+        for (const auto &succ_ptr : dag[exec_id]->get_successors())
+        {
+            const simgrid_comm_t *comm = dynamic_cast<simgrid_comm_t *>(succ_ptr.get());
+            if (!comm || comm->get_successors().empty()) continue;
+
+            auto dst_it = exec_to_id.find(comm->get_successors().front().get());
+            if (dst_it == exec_to_id.end()) continue;
+
+            unsigned int comm_id = workflow.comm_names.size();
+            workflow.comm_names.push_back(comm->get_name());
+            workflow.comm_payloads.push_back(comm->get_remaining());
+            workflow.comm_src_exec_ids.push_back(exec_id);
+            workflow.comm_dst_exec_ids.push_back(dst_it->second);
+            workflow.exec_out_comm_ids.push_back(comm_id);
+        }
+
+        workflow.exec_out_offsets.push_back(workflow.exec_out_comm_ids.size());
+    }
+
+    common_workflow_tables_initialize(common);
+}
+
+/**
+ * @brief Load the workflow from a binary DAG file (dag.hpp).
+ *
+ * The sections are copied as they are; only the in-adjacency and the tables are built, as for a DOT dag.
+ */
+void common_workflow_initialize_from_dag_file(common_t *common, const dag_file_t &dag)
+{
+    workflow_t &workflow = common->workflow;
+    size_t execs_count = dag.header->execs_count;
+    size_t comms_count = dag.header->comms_count;
+
+    workflow.exec_names.resize(execs_count);
+    for (size_t exec_id = 0; exec_id < execs_count; ++exec_id)
+        workflow.exec_names[exec_id] = dag_exec_name(dag, exec_id);
+
+    workflow.comm_names.resize(comms_count);
+    for (size_t comm_id = 0; comm_id < comms_count; ++comm_id)
+        workflow.comm_names[comm_id] = dag_comm_name(dag, comm_id);
+
+    workflow.exec_flops.assign(dag.exec_flops, dag.exec_flops + execs_count);
+    workflow.comm_payloads.assign(dag.comm_payloads, dag.comm_payloads + comms_count);
+    workflow.exec_out_offsets.assign(dag.exec_out_offsets, dag.exec_out_offsets + execs_count + 1);
+    workflow.comm_dst_exec_ids.assign(dag.comm_dst_exec_ids, dag.comm_dst_exec_ids + comms_count);
+
+    // comm_ids are numbered by source exec.
+    workflow.exec_out_comm_ids.resize(comms_count);
+    std::iota(workflow.exec_out_comm_ids.begin(), workflow.exec_out_comm_ids.end(), 0);
+
+    workflow.comm_src_exec_ids.resize(comms_count);
+    for (unsigned int exec_id = 0; exec_id < execs_count; ++exec_id)
+        for (unsigned int comm_id : common_exec_id_get_out_comm_ids(common, exec_id))
+            workflow.comm_src_exec_ids[comm_id] = exec_id;
+
+    common_workflow_tables_initialize(common);
+}
+
+// Task of a WfCommons instance: tasks and files are keyed by id (schema >= 1.5) or by name (older schemas).
+struct common_wfcommons_task_s
+{
+    std::string name;
+    double runtime_s;
+    double cores;
+    std::vector<std::string> parents;
+    std::vector<std::string> children;
+    std::vector<std::string> input_files;
+    std::vector<std::string> output_files;
+};
+typedef struct common_wfcommons_task_s common_wfcommons_task_t;
+
+// Before schema 1.5, tasks may have both a name and an id, but parents, children and files refer to names.
+static std::string common_wfcommons_key(const nlohmann::json &object, bool by_id)
+{
+    const char *key = by_id ? "id" : "name";
+    const char *other_key = by_id ? "name" : "id";
+    return object.contains(key) ? object[key].get<std::string>() : object.at(other_key).get<std::string>();
+}
+
+static double common_wfcommons_number(const nlohmann::json &object, const char *key, const char *old_key, double default_value)
+{
+    if (object.contains(key)) return object[key].get<double>();
+    if (object.contains(old_key)) return object[old_key].get<double>();
+    return default_value;
+}
+
+/**
+ * @brief Load the workflow from a WfCommons (Pegasus) JSON instance (dag_file with the .json extension).
+ *
+ * Both the schema 1.5 layout (workflow.specification/execution, keyed by id) and the older ones
+ * (workflow.tasks, or workflow.jobs for WorkflowHub instances, with runtime, cores and files;
+ * keyed by name) are read. Only the fields below are kept while the file is streamed into the
+ * parser, so large instances never hold their machines, commands or arguments in memory.
+ * - exec: one per task (named by its key); flops = runtime (s) x cores x core_flops_per_second.
+ * - comm: one per parent -> child dependency; payload = bytes of the output files of the parent
+ *   that are input files of the child (0 for control dependencies).
+ * The virtual entry and exit tasks of the DOT convention (root, end) are implicit: tasks without
+ * parents are ready from the start, and tasks without children have no out-comms.
+ */
+void common_workflow_initialize_from_wfcommons(common_t *common, const std::string &file_name, double core_flops_per_second)
+{
+    std::ifstream file(file_name);
+    if (!file.is_open())
+    {
+        XBT_ERROR("Could not open WfCommons file '%s'.", file_name.c_str());
+        throw std::runtime_error("Could not open WfCommons file '" + file_name + "'.");
+    }
+
+    static const std::unordered_set<std::string> keys = {
+        "workflow", "specification", "execution", "tasks", "jobs", "files", "id", "name", "parents", "children",
+        "inputFiles", "outputFiles", "link", "sizeInBytes", "size", "runtimeInSeconds", "runtime", "coreCount", "cores"};
+
+    nlohmann::json::parser_callback_t filter = [](int, nlohmann::json::parse_event_t event, nlohmann::json &parsed) {
+        return event != nlohmann::json::parse_event_t::key || keys.count(parsed.get<std::string>()) > 0;
+    };
+
+    nlohmann::json data;
+    try {
+        data = nlohmann::json::parse(file, filter);
+    } catch (const nlohmann::json::exception &e) {
+        XBT_ERROR("Invalid WfCommons file '%s': %s", file_name.c_str(), e.what());
+        throw std::runtime_error("Invalid WfCommons file '" + file_name + "'.");
+    }
+
+    const nlohmann::json &workflow_json = data.at("workflow");
+    bool specification = workflow_json.contains("specification");
+    const nlohmann::json &tasks_json = specification ? workflow_json["specification"].at("tasks")
+        : workflow_json.contains("tasks") ? workflow_json["tasks"] : workflow_json.at("jobs");
+
+    // 1. Tasks, in file order (exec_id).
+    std::vector<common_wfcommons_task_t> tasks(tasks_json.size());
+    std::unordered_map<std::string, unsigned int> task_id_to_exec_id;
+    std::unordered_map<std::string, double> file_id_to_bytes;
+
+    for (unsigned int exec_id = 0; exec_id < tasks_json.size(); ++exec_id)
+    {
+        const nlohmann::json &task_json = tasks_json[exec_id];
+        common_wfcommons_task_t &task = tasks[exec_id];
+
+        task.name = common_wfcommons_key(task_json, specification);
+        task.runtime_s = common_wfcommons_number(task_json, "runtimeInSeconds", "runtime", -1.0);
+        task.cores = common_wfcommons_number(task_json, "coreCount", "cores", 1.0);
+        task.parents = task_json.value("parents", std::vector<std::string>());
+        task.children = task_json.value("children", std::vector<std::string>());
+
+        if (specification)
+        {
+            task.input_files = task_json.value("inputFiles", std::vector<std::string>());
+            task.output_files = task_json.value("outputFiles", std::vector<std::string>());
+        }
+        else
+        {
+            for (const nlohmann::json &file_json : task_json.value("files", nlohmann::json::array()))
+            {
+                std::string file_id = common_wfcommons_key(file_json, specification);
+                file_id_to_bytes[file_id] = common_wfcommons_number(file_json, "sizeInBytes", "size", 0.0);
+                (file_json.value("link", "") == "output" ? task.output_files : task.input_files).push_back(file_id);
+            }
+        }
+
+        if (!task_id_to_exec_id.emplace(task.name, exec_id).second)
+        {
+            XBT_ERROR("Duplicated task '%s' in WfCommons file '%s'.", task.name.c_str(), file_name.c_str());
+            throw std::runtime_error("Duplicated task '" + task.name + "' in WfCommons file.");
+        }
+    }
+
+    if (specification)
+        for (const nlohmann::json &file_json : workflow_json["specification"].value("files", nlohmann::json::array()))
+            file_id_to_bytes[common_wfcommons_key(file_json, specification)] = common_wfcommons_number(file_json, "sizeInBytes", "size", 0.0);
+
+    // Schema 1.5 keeps the runtimes apart from the specification.
+    if (specification && workflow_json.contains("execution"))
+    {
+        for (const nlohmann::json &task_json : workflow_json["execution"].value("tasks", nlohmann::json::array()))
+        {
+            auto it = task_id_to_exec_id.find(common_wfcommons_key(task_json, specification));
+            if (it == task_id_to_exec_id.end()) continue;
+
+            tasks[it->second].runtime_s = common_wfcommons_number(task_json, "runtimeInSeconds", "runtime", tasks[it->second].runtime_s);
+            tasks[it->second].cores = common_wfcommons_number(task_json, "coreCount", "cores", tasks[it->second].cores);
+        }
+    }
+
+    auto exec_id_get = [&](const std::string &task_id) {
+        auto it = task_id_to_exec_id.find(task_id);
+        if (it == task_id_to_exec_id.end())
+        {
+            XBT_ERROR("Unknown task '%s' in WfCommons file '%s'.", task_id.c_str(), file_name.c_str());
+            throw std::runtime_error("Unknown task '" + task_id + "' in WfCommons file.");
+        }
+        return it->second;
+    };
+
+    // 2. Dependencies (children and parents lists may each be incomplete), sorted by destination exec_id.
+    std::vector<std::vector<unsigned int>> exec_id_to_children(tasks.size());
+    for (unsigned int exec_id = 0; exec_id < tasks.size(); ++exec_id)
+    {
+        for (const std::string &child : tasks[exec_id].children)
+            exec_id_to_children[exec_id].push_back(exec_id_get(child));
+        for (const std::string &parent : tasks[exec_id].parents)
+            exec_id_to_children[exec_id_get(parent)].push_back(exec_id);
+    }
+
+    // 3. Workflow tables (comm_ids numbered by source exec, as for DOT dags).
+    workflow_t &workflow = common->workflow;
+    workflow.exec_out_offsets.assign(1, 0);
+
+    for (unsigned int exec_id = 0; exec_id < tasks.size(); ++exec_id)
+    {
+        const common_wfcommons_task_t &task = tasks[exec_id];
+
+        if (task.runtime_s < 0)
+        {
+            XBT_ERROR("Task '%s' has no runtime in WfCommons file '%s'.", task.name.c_str(), file_name.c_str());
+            throw std::runtime_error("Task '" + task.name + "' has no runtime in WfCommons file.");
+        }
+
+        workflow.exec_names.push_back(task.name);
+        workflow.exec_flops.push_back(task.runtime_s * task.cores * core_flops_per_second);
+
+        std::vector<unsigned int> &children = exec_id_to_children[exec_id];
+        std::sort(children.begin(), children.end());
+        children.erase(std::unique(children.begin(), children.end()), children.end());
+
+        std::unordered_set<std::string> output_files(task.output_files.begin(), task.output_files.end());
+
+        for (unsigned int child_exec_id : children)
+        {
+            double payload = 0.0;
+            for (const std::string &file_id : tasks[child_exec_id].input_files)
+                if (output_files.count(file_id))
+                    payload += file_id_to_bytes[file_id];
+
+            unsigned int comm_id = workflow.comm_names.size();
+            workflow.comm_names.push_back(task.name + "->" + tasks[child_exec_id].name);
+            workflow.comm_payloads.push_back(payload);
+            workflow.comm_src_exec_ids.push_back(exec_id);
+            workflow.comm_dst_exec_ids.push_back(child_exec_id);
+            workflow.exec_out_comm_ids.push_back(comm_id);
+        }
+
+        workflow.exec_out_offsets.push_back(workflow.exec_out_comm_ids.size());
+    }
+
+    common_workflow_tables_initialize(common);
+
+    XBT_INFO("WfCommons file: %s (execs: %zu, comms: %zu)", file_name.c_str(), workflow.exec_names.size(), workflow.comm_names.size());
+}
+
+/**
+ * @brief Copy a loaded workflow (e.g., shared by the sweep workers) and build the tables of common.
+ */
+void common_workflow_initialize_from_workflow(common_t *common, const workflow_t &workflow)
+{
+    common->workflow = workflow;
+    common_workflow_tables_initialize(common);
+}
+
+/**
+ * @brief Write the workflow as a binary DAG file (nflows --convert-dag).
+ */
+void common_workflow_write_to_dag_file(const common_t *common, const std::string &file_name)
 {
-    simgrid_execs_t ready_execs;
-    for (auto &exec : execs)
-        if (exec->dependencies_solved() && not exec->is_assigned())
-            ready_execs.push_back(exec);
+    const workflow_t &workflow = common->workflow;
 
-    return ready_execs;
+    dag_write(file_name, workflow.exec_names, workflow.exec_flops, workflow.exec_out_offsets,
+        workflow.comm_dst_exec_ids, workflow.comm_names, workflow.comm_payloads);
+}
+
+/**
+ * @brief Build the in-adjacency, the id-indexed tables and the ready-set once the out-adjacency is set.
+ */
+static void common_workflow_tables_initialize(common_t *common)
+{
+    workflow_t &workflow = common->workflow;
+    size_t execs_count = workflow.exec_names.size();
+    size_t comms_count = workflow.comm_names.size();
+
+    std::vector<unsigned int> exec_in_degree(execs_count, 0);
+    for (unsigned int dst_exec_id : workflow.comm_dst_exec_ids)
+        exec_in_degree[dst_exec_id] += 1;
+
+    // 3. Build the in-adjacency (comms are visited in comm_id order).
+
+    workflow.exec_in_offsets.assign(execs_count + 1, 0);
+    for (unsigned int exec_id = 0; exec_id < execs_count; ++exec_id)
+        workflow.exec_in_offsets[exec_id + 1] = workflow.exec_in_offsets[exec_id] + exec_in_degree[exec_id];
+
+    std::vector<unsigned int> exec_in_fill(workflow.exec_in_offsets.begin(), workflow.exec_in_offsets.end() - 1);
+    workflow.exec_in_comm_ids.resize(comms_count);
+    for (unsigned int comm_id = 0; comm_id < comms_count; ++comm_id)
+        workflow.exec_in_comm_ids[exec_in_fill[workflow.comm_dst_exec_ids[comm_id]]++] = comm_id;
+
+    // 4. Preallocate the trace tables.
+    common_table_resize(common->execs_active, execs_count);
+    common_table_resize(common->reads_active, comms_count);
+    common_table_resize(common->writes_active, comms_count);
+
+    common_table_resize(common->comm_id_to_address, comms_count);
+    common_table_resize(common->comm_id_to_numa_ids_r, comms_count);
+    common_table_resize(common->comm_id_to_numa_ids_w, comms_count);
+
+    common->exec_id_to_core_id.assign(execs_count, -1);
+    common_table_resize(common->exec_id_to_thread_locality, execs_count);
+
+    common_table_resize(common->comm_id_to_r_ts_range_payload, comms_count);
+    common_table_resize(common->comm_id_to_w_ts_range_payload, comms_count);
+    common_table_resize(common->exec_id_to_c_ts_range_payload, execs_count);
+
+    common_table_resize(common->comm_id_to_r_time_offset_payload, comms_count);
+    common_table_resize(common->comm_id_to_w_time_offset_payload, comms_count);
+    common_table_resize(common->exec_id_to_c_time_offset_payload, execs_count);
+    common_table_resize(common->exec_id_to_rcw_time_offset_payload, execs_count);
+    common_table_resize(common->comm_id_to_m_time_offset_payload, comms_count);
+
+    // 5. Initialize the ready-set with the execs without in-comms (root->* comms are already completed).
+    common->exec_id_to_deps_pending = exec_in_degree;
+    common->execs_ready.clear();
+    common->execs_ready_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    for (unsigned int exec_id = 0; exec_id < execs_count; ++exec_id)
+        if (exec_in_degree[exec_id] == 0)
+            common->execs_ready.push_back(exec_id);
+}
+
+id_range_t common_exec_id_get_in_comm_ids(const common_t *common, unsigned int exec_id)
+{
+    const workflow_t &workflow = common->workflow;
+    const unsigned int *comm_ids = workflow.exec_in_comm_ids.data();
+    return {comm_ids + workflow.exec_in_offsets[exec_id], comm_ids + workflow.exec_in_offsets[exec_id + 1]};
+}
+
+id_range_t common_exec_id_get_out_comm_ids(const common_t *common, unsigned int exec_id)
+{
+    const workflow_t &workflow = common->workflow;
+    const unsigned int *comm_ids = workflow.exec_out_comm_ids.data();
+    return {comm_ids + workflow.exec_out_offsets[exec_id], comm_ids + workflow.exec_out_offsets[exec_id + 1]};
+}
+
+/**
+ * @brief Start timing a scheduling decision (scheduler.next()) and reset its counters.
+ */
+void common_scheduler_decision_begin(common_t *common)
+{
+    scheduler_stats_t &stats = common->scheduler_stats;
+
+    stats.decision_cores_evaluated = 0;
+    stats.decision_execs_evaluated = 0;
+    stats.decision_start_time_us = common_get_monotonic_time_us();
+}
+
+/**
+ * @brief Record the decision started by common_scheduler_decision_begin; returns its duration.
+ */
+double common_scheduler_decision_end(common_t *common)
+{
+    scheduler_stats_t &stats = common->scheduler_stats;
+    double decision_time_us = common_get_monotonic_time_us() - stats.decision_start_time_us;
+
+    stats.next_times_us.push_back(decision_time_us);
+    stats.cores_evaluated.push_back(stats.decision_cores_evaluated);
+    stats.execs_evaluated.push_back(stats.decision_execs_evaluated);
+
+    if (stats.charge_decision_time)
+        stats.decision_clock_us += decision_time_us;
+
+    return decision_time_us;
+}
+
+/**
+ * @brief Select the trace backend (after common_workflow_initialize and hardware_perf_counters_initialize).
+ *
+ * With the binary backend, trace entries are streamed to file_name and the tables that are only
+ * written (i.e., not read back by the schedulers or the mappers) are released.
+ */
+void common_trace_initialize(common_t *common, trace_backend_t backend, const std::string &file_name)
+{
+    common->trace_writer.backend = backend;
+    if (backend != TRACE_BACKEND_BINARY) return;
+
+    // Upper bound of the records of a run (every table slot written once).
+    size_t execs_count = common->workflow.exec_names.size();
+    size_t comms_count = common->workflow.comm_names.size();
+    size_t capacity_records = 7 * comms_count + (4 + COMMON_PHASES_COUNT * common->exec_id_to_perf_counters.counters_count) * execs_count;
+
+    trace_open(common->trace_writer, file_name, capacity_records);
+
+    common_table_release(common->comm_id_to_numa_ids_r);
+    common_table_release(common->exec_id_to_thread_locality);
+    common_table_release(common->exec_id_to_perf_counters.values);
+    common_table_release(common->exec_id_to_perf_counters.recorded);
+
+    common_table_release(common->comm_id_to_r_ts_range_payload);
+    common_table_release(common->comm_id_to_w_ts_range_payload);
+    common_table_release(common->exec_id_to_c_ts_range_payload);
+
+    common_table_release(common->comm_id_to_r_time_offset_payload);
+    common_table_release(common->exec_id_to_c_time_offset_payload);
+    common_table_release(common->comm_id_to_m_time_offset_payload);
+}
+
+void common_trace_finalize(common_t *common)
+{
+    trace_close(common->trace_writer, common->workflow.exec_names, common->workflow.comm_names, common->perf_counter_names,
+        common->perf_counter_names.empty() ? "" : common_perf_counters_type_to_str(common->perf_counters_type));
+}
+
+/**
+ * @brief Open the timeline (Chrome Trace Event JSON) and name one track per available core.
+ *
+ * Does nothing if file_name is empty.
+ */
+void common_timeline_initialize(common_t *common, const std::string &file_name)
+{
+    if (file_name.empty()) return;
+
+    trace_timeline_open(common->trace_timeline, file_name);
+
+    const std::vector<int> &core_id_to_numa_id = common->topology_tables.core_id_to_numa_id;
+    for (size_t core_id = 0; core_id < common->core_avail.size(); ++core_id)
+        if (common->core_avail[core_id])
+            trace_timeline_track(common->trace_timeline, core_id < core_id_to_numa_id.size() ? core_id_to_numa_id[core_id] : -1, core_id);
+}
+
+void common_timeline_finalize(common_t *common)
+{
+    trace_timeline_close(common->trace_timeline);
 }
 
 clock_frequency_type_t common_clock_frequency_str_to_type(const std::string &type)
@@ -203,6 +691,24 @@ std::string common_mapper_type_to_str(const mapper_type_t &type)
     }
 }
 
+simulation_engine_t common_simulation_engine_str_to_type(const std::string &type)
+{
+    if (type.empty() || type.compare("list") == 0) return COMMON_SIMULATION_ENGINE_LIST;
+    if (type.compare("event") == 0) return COMMON_SIMULATION_ENGINE_EVENT;
+
+    XBT_ERROR("Unsupported simulation engine '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported simulation engine '" + type + "'.");
+}
+
+std::string common_simulation_engine_type_to_str(const simulation_engine_t &type)
+{
+    switch (type) {
+        case COMMON_SIMULATION_ENGINE_LIST: return "list";
+        case COMMON_SIMULATION_ENGINE_EVENT: return "event";
+        default: return "";
+    }
+}
+
 hwloc_membind_policy_t common_mapper_mem_policy_str_to_type(const std::string &type)
 {
     if (type.compare("default") == 0) return HWLOC_MEMBIND_DEFAULT;
@@ -231,6 +737,78 @@ std::string common_mapper_mem_policy_type_to_str(const hwloc_membind_policy_t &t
     throw std::runtime_error("Unsupported memory policy type.");
 }
 
+huge_pages_type_t common_huge_pages_str_to_type(const std::string &type)
+{
+    if (type.compare("none") == 0) return COMMON_HUGE_PAGES_NONE;
+    if (type.compare("transparent") == 0) return COMMON_HUGE_PAGES_TRANSPARENT;
+    if (type.compare("explicit") == 0) return COMMON_HUGE_PAGES_EXPLICIT;
+
+    XBT_ERROR("Unsupported huge pages type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported huge pages type '" + type + "'.");
+}
+
+std::string common_huge_pages_type_to_str(const huge_pages_type_t &type)
+{
+    switch (type) {
+        case COMMON_HUGE_PAGES_NONE: return "none";
+        case COMMON_HUGE_PAGES_TRANSPARENT: return "transparent";
+        case COMMON_HUGE_PAGES_EXPLICIT: return "explicit";
+        default: return "";
+    }
+}
+
+perf_counters_type_t common_perf_counters_str_to_type(const std::string &type)
+{
+    if (type.compare("none") == 0) return COMMON_PERF_COUNTERS_NONE;
+    if (type.compare("hardware") == 0) return COMMON_PERF_COUNTERS_HARDWARE;
+    if (type.compare("software") == 0) return COMMON_PERF_COUNTERS_SOFTWARE;
+    if (type.compare("rusage") == 0) return COMMON_PERF_COUNTERS_RUSAGE;
+
+    XBT_ERROR("Unsupported perf counters type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported perf counters type '" + type + "'.");
+}
+
+std::string common_perf_counters_type_to_str(const perf_counters_type_t &type)
+{
+    switch (type) {
+        case COMMON_PERF_COUNTERS_NONE: return "none";
+        case COMMON_PERF_COUNTERS_HARDWARE: return "hardware";
+        case COMMON_PERF_COUNTERS_SOFTWARE: return "software";
+        case COMMON_PERF_COUNTERS_RUSAGE: return "rusage";
+        default: return "";
+    }
+}
+
+std::string common_phase_type_to_str(const phase_type_t &type)
+{
+    switch (type) {
+        case COMMON_PHASE_READ: return "read";
+        case COMMON_PHASE_COMPUTE: return "compute";
+        case COMMON_PHASE_WRITE: return "write";
+        default: return "";
+    }
+}
+
+numa_memory_policy_t common_numa_memory_policy_str_to_type(const std::string &type)
+{
+    if (type.empty() || type.compare("none") == 0) return COMMON_NUMA_MEMORY_POLICY_NONE;
+    if (type.compare("penalize") == 0) return COMMON_NUMA_MEMORY_POLICY_PENALIZE;
+    if (type.compare("forbid") == 0) return COMMON_NUMA_MEMORY_POLICY_FORBID;
+
+    XBT_ERROR("Unsupported numa memory policy '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported numa memory policy '" + type + "'.");
+}
+
+std::string common_numa_memory_policy_type_to_str(const numa_memory_policy_t &type)
+{
+    switch (type) {
+        case COMMON_NUMA_MEMORY_POLICY_NONE: return "none";
+        case COMMON_NUMA_MEMORY_POLICY_PENALIZE: return "penalize";
+        case COMMON_NUMA_MEMORY_POLICY_FORBID: return "forbid";
+        default: return "";
+    }
+}
+
 distance_matrix_t common_distance_matrix_read_from_txt(const std::string &txt_file)
 {
     std::ifstream file(txt_file);
@@ -258,6 +836,28 @@ distance_matrix_t common_distance_matrix_read_from_txt(const std::string &txt_fi
     return matrix;
 }
 
+/**
+ * @brief Write a matrix in the format read by common_distance_matrix_read_from_txt.
+ */
+void common_distance_matrix_write_to_txt(const distance_matrix_t &matrix, const std::string &txt_file)
+{
+    std::ofstream file(txt_file);
+    if (!file.is_open())
+    {
+        XBT_ERROR("Could not open file '%s'.", txt_file.c_str());
+        throw std::runtime_error("Could not open file '" + txt_file + "'.");
+    }
+
+    file << matrix.size() << "\n";
+
+    for (const std::vector<double> &row : matrix)
+    {
+        for (size_t j = 0; j < row.size(); ++j)
+            file << (j ? " " : "") << std::fixed << std::setprecision(2) << row[j];
+        file << "\n";
+    }
+}
+
 std::vector<int> common_core_id_get_avail(const common_t *common)
 {
     unsigned int i = 0;
@@ -280,7 +880,8 @@ void common_core_id_set_avail(common_t *common, unsigned int core_id, bool avail
 double common_core_id_get_avail_until(const common_t *common, unsigned int core_id)
 {
     try {
-        return common->core_avail_until.at(core_id);
+        // An idle core cannot start anything before the current event time (event engine).
+        return std::max(common->core_avail_until.at(core_id), common->simulation_clock_us);
     } catch (const std::out_of_range& e) {
         XBT_ERROR("Not found core_id: %d", core_id);
         throw;
@@ -292,38 +893,130 @@ void common_core_id_set_avail_until(common_t *common, unsigned int core_id, doub
     common->core_avail_until[core_id] = duration;
 }
 
-name_to_time_range_payload_t common_comm_name_to_w_time_offset_payload_filter(const common_t *common, const std::string &dst_name)
+numa_mask_t common_numa_ids_to_mask(const std::vector<int> &numa_ids)
+{
+    numa_mask_t numa_mask = 0;
+    for (int numa_id : numa_ids)
+    {
+        if (numa_id < 0 || numa_id >= (int) (8 * sizeof(numa_mask_t)))
+        {
+            XBT_ERROR("Unsupported numa_id: %d", numa_id);
+            throw std::runtime_error("Unsupported numa_id: " + std::to_string(numa_id));
+        }
+        numa_mask |= ((numa_mask_t) 1) << numa_id;
+    }
+
+    return numa_mask;
+}
+
+std::vector<int> common_numa_mask_to_ids(numa_mask_t numa_mask)
+{
+    std::vector<int> numa_ids;
+    for (int numa_id = 0; numa_mask; ++numa_id, numa_mask >>= 1)
+        if (numa_mask & 1)
+            numa_ids.push_back(numa_id);
+
+    return numa_ids;
+}
+
+int common_numa_mask_first(numa_mask_t numa_mask)
+{
+    if (!numa_mask)
+    {
+        XBT_ERROR("Empty numa_mask.");
+        throw std::runtime_error("Empty numa_mask.");
+    }
+
+    return __builtin_ctzll(numa_mask);
+}
+
+int common_numa_mask_count(numa_mask_t numa_mask)
+{
+    return __builtin_popcountll(numa_mask);
+}
+
+/**
+ * @brief Reset the resident bytes of every NUMA node (numa_id_to_capacity_bytes must be set).
+ */
+void common_numa_memory_initialize(common_t *common)
+{
+    size_t numa_count = common->numa_id_to_capacity_bytes.size();
+
+    common->numa_id_to_resident_bytes.assign(numa_count, 0.0);
+    common->numa_id_to_peak_resident_bytes.assign(numa_count, 0.0);
+    common->numa_memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+}
+
+double common_numa_id_get_budget_bytes(const common_t *common, int numa_id)
+{
+    double capacity_bytes = common->numa_id_to_capacity_bytes[numa_id];
+
+    if (capacity_bytes <= 0.0) return std::numeric_limits<double>::infinity();
+
+    return common->numa_memory_budget_ratio * capacity_bytes;
+}
+
+double common_numa_id_get_resident_bytes(common_t *common, int numa_id)
+{
+    pthread_mutex_lock(&(common->numa_memory_mutex));
+    double resident_bytes = common->numa_id_to_resident_bytes[numa_id];
+    pthread_mutex_unlock(&(common->numa_memory_mutex));
+
+    return resident_bytes;
+}
+
+/**
+ * @brief Highest resident/budget ratio among the NUMA nodes with a budget (0 if none has one).
+ */
+double common_numa_memory_get_utilization(common_t *common)
 {
-    name_to_time_range_payload_t matches;
+    double utilization = 0.0;
 
-    for (const auto &[key, value] : common->comm_name_to_w_time_offset_payload)
+    pthread_mutex_lock(&(common->numa_memory_mutex));
+    for (size_t numa_id = 0; numa_id < common->numa_id_to_resident_bytes.size(); ++numa_id)
     {
-        auto [left, right] = common_split(key, "->");
-        if (dst_name == right)
-            matches[key] = value;
+        double budget_bytes = common_numa_id_get_budget_bytes(common, numa_id);
+        if (std::isfinite(budget_bytes) && budget_bytes > 0.0)
+            utilization = std::max(utilization, common->numa_id_to_resident_bytes[numa_id] / budget_bytes);
     }
+    pthread_mutex_unlock(&(common->numa_memory_mutex));
+
+    return utilization;
+}
+
+// The bytes of a data item spread over several NUMA nodes are split evenly among them.
+static void common_numa_memory_update(common_t *common, numa_mask_t numa_mask, double bytes)
+{
+    int numa_ids_count = common_numa_mask_count(numa_mask);
+    if (numa_ids_count == 0) return;
 
-    return matches;
+    pthread_mutex_lock(&(common->numa_memory_mutex));
+    for (int numa_id : common_numa_mask_to_ids(numa_mask))
+    {
+        if ((size_t) numa_id >= common->numa_id_to_resident_bytes.size()) continue;
+
+        double &resident_bytes = common->numa_id_to_resident_bytes[numa_id];
+        resident_bytes = std::max(0.0, resident_bytes + bytes / numa_ids_count);
+        common->numa_id_to_peak_resident_bytes[numa_id] = std::max(common->numa_id_to_peak_resident_bytes[numa_id], resident_bytes);
+    }
+    pthread_mutex_unlock(&(common->numa_memory_mutex));
 }
 
 /* USER UTILS */
-double common_earliest_start_time(const common_t *common, const std::string &exec_name, unsigned int core_id)
+double common_earliest_start_time(const common_t *common, unsigned int exec_id, unsigned int core_id)
 {
     // EST(n_i,p_i) = max{ avail[j], max_{n_{m} e pred(n_i)}( AFT(n_{m}) + c_{m,i} ) };
     // - avail[j]  => earliest time which processor j will be ready for task execution.
     // - pred(n_i) => set of immediate predecessor tasks of task n_{i}.
 
-    // Match all communication (Task1->Task2) where this task_name is the destination.
+    // Match all communication (Task1->Task2) where this task is the destination.
     double max_pred_actual_finish_time = 0.0;
 
-    name_to_time_range_payload_t matches = common_comm_name_to_w_time_offset_payload_filter(common, exec_name);
-
-    for (const auto &[comm_name, time_range_payload] : matches)
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(common, exec_id))
     {
-        auto [pred_exec_name, self_exec_name] = common_split(comm_name, "->");
-        time_range_payload_t rcw_time_offset_payload = common_exec_name_to_rcw_time_offset_payload_get(common, pred_exec_name);
-        double pred_exec_name_end_time_offset = std::get<1>(rcw_time_offset_payload);
-        max_pred_actual_finish_time = std::max(max_pred_actual_finish_time, pred_exec_name_end_time_offset);
+        unsigned int pred_exec_id = common->workflow.comm_src_exec_ids[comm_id];
+        double pred_exec_end_time_offset = std::get<1>(common_exec_id_to_rcw_time_offset_payload_get(common, pred_exec_id));
+        max_pred_actual_finish_time = std::max(max_pred_actual_finish_time, pred_exec_end_time_offset);
     }
 
     double core_id_avail_until = common_core_id_get_avail_until(common, core_id);
@@ -332,6 +1025,39 @@ double common_earliest_start_time(const common_t *common, const std::string &exe
     return earliest_start_time_us;
 }
 
+/**
+ * @brief Latest availability of the cores, i.e., the makespan once all the execs are done.
+ */
+double common_makespan(const common_t *common)
+{
+    double makespan_us = 0.0;
+    for (double avail_until_us : common->core_avail_until)
+        makespan_us = std::max(makespan_us, avail_until_us);
+
+    return makespan_us;
+}
+
+/**
+ * @brief Bytes read from a NUMA node other than the one of the reading core (migrated items are local).
+ */
+double common_remote_read_bytes(const common_t *common)
+{
+    const workflow_t &workflow = common->workflow;
+    double remote_bytes = 0.0;
+
+    for (unsigned int comm_id = 0; comm_id < workflow.comm_names.size(); ++comm_id)
+    {
+        int core_id = common->exec_id_to_core_id[workflow.comm_dst_exec_ids[comm_id]];
+        if (!common->comm_id_to_numa_ids_r.recorded[comm_id] || core_id < 0) continue;
+
+        int numa_id = common->topology_tables.core_id_to_numa_id[core_id];
+        if (!(common->comm_id_to_numa_ids_r.numa_mask[comm_id] & ((numa_mask_t) 1 << numa_id)))
+            remote_bytes += workflow.comm_payloads[comm_id];
+    }
+
+    return remote_bytes;
+}
+
 double common_communication_time(const common_t *common, unsigned int src_numa_id, unsigned int dst_numa_id, double payload)
 {
     double latency_ns = common->distance_lat_ns[src_numa_id][dst_numa_id];
@@ -343,10 +1069,53 @@ double common_communication_time(const common_t *common, unsigned int src_numa_i
     return latency_us + (payload / bandwidth_bpus);
 }
 
-double common_compute_time(const common_t *common, double flops, double clock_frequency_hz)
+/**
+ * @brief Time (us) until the data item of comm_id is read from dst_numa_id by an exec starting at earliest_start_time_us.
+ *
+ * By default the item is read remotely from the NUMA node it was written to. With mapper_prefetch,
+ * it may instead be migrated to dst_numa_id as soon as the exec is assigned (no earlier than the end
+ * of the write); only the part of the migration not overlapped before earliest_start_time_us is
+ * charged, followed by a local read. The cheapest option is returned.
+ *
+ * @param migration_time_us Set to the full migration time, or 0 when the item is read remotely.
+ */
+double common_comm_id_read_time(const common_t *common, unsigned int comm_id, unsigned int dst_numa_id, double earliest_start_time_us, double *migration_time_us)
+{
+    double payload = common->workflow.comm_payloads[comm_id];
+    int src_numa_id = common_numa_mask_first(common_comm_id_to_numa_ids_w_get(common, comm_id));
+
+    double remote_read_time_us = common_communication_time(common, src_numa_id, dst_numa_id, payload);
+    *migration_time_us = 0.0;
+
+    if (!common->mapper_prefetch || (unsigned int) src_numa_id == dst_numa_id) return remote_read_time_us;
+
+    // Pages are copied from the source to the destination node, then read locally.
+    double write_end_time_us = std::get<1>(common_comm_id_to_w_time_offset_payload_get(common, comm_id));
+    double slack_time_us = std::max(0.0, earliest_start_time_us - write_end_time_us);
+
+    double full_migration_time_us = common_communication_time(common, src_numa_id, dst_numa_id, payload);
+    double local_read_time_us = common_communication_time(common, dst_numa_id, dst_numa_id, payload);
+    double migrated_read_time_us = std::max(0.0, full_migration_time_us - slack_time_us) + local_read_time_us;
+
+    if (migrated_read_time_us >= remote_read_time_us) return remote_read_time_us;
+
+    *migration_time_us = full_migration_time_us;
+    return migrated_read_time_us;
+}
+
+double common_compute_time(const common_t *common, unsigned int core_id, double flops, double clock_frequency_hz)
 {
     // Calculate the compute time in microseconds.
-    return (flops / (common->flops_per_cycle * clock_frequency_hz)) * 1000000;
+    return (flops / (common_core_id_get_flops_per_cycle(common, core_id) * clock_frequency_hz)) * 1000000;
+}
+
+double common_core_id_get_flops_per_cycle(const common_t *common, unsigned int core_id)
+{
+    // Calibrated value when available, otherwise the user-defined one.
+    if (core_id < common->core_id_to_flops_per_cycle.size())
+        return common->core_id_to_flops_per_cycle[core_id];
+
+    return common->flops_per_cycle;
 }
 
 int common_simulation_find_first_available_core_id(const common_t *common)
@@ -360,7 +1129,7 @@ int common_simulation_find_first_available_core_id(const common_t *common)
     XBT_DEBUG("current_simulation_time: %f", current_simulation_time);
 
     int first_core_id = *std::find_if(avail_core_ids.begin(), avail_core_ids.end(), [&](int core_id) {
-        return common->core_avail_until.at(core_id) <= current_simulation_time;
+        return common_core_id_get_avail_until(common, core_id) <= current_simulation_time;
     });
 
     return first_core_id;
@@ -385,8 +1154,8 @@ void common_threads_active_decrement(common_t *common)
 {
     pthread_mutex_lock(&(common->threads_mutex));
     common->threads_active -= 1;
-    if (common->threads_active == 0)
-        pthread_cond_signal(&(common->threads_cond)); // Signal the main thread
+    common->threads_completed += 1;
+    pthread_cond_signal(&(common->threads_cond)); // Signal the main thread (completion event)
     pthread_mutex_unlock(&(common->threads_mutex));
 }
 
@@ -399,112 +1168,386 @@ void common_threads_active_wait(common_t *common)
     pthread_mutex_unlock(&(common->threads_mutex));
 }
 
-void common_execs_active_increment(common_t *common, const std::string &name)
+void common_threads_failed_increment(common_t *common)
 {
-    std::lock_guard<std::mutex> lock(common->counters_mutex);
-    common->execs_active[name] += 1;
+    pthread_mutex_lock(&(common->threads_mutex));
+    common->threads_failed += 1;
+    pthread_mutex_unlock(&(common->threads_mutex));
 }
 
-void common_reads_active_increment(common_t *common, const std::string &name)
+unsigned int common_threads_failed_get(common_t *common)
 {
-    std::lock_guard<std::mutex> lock(common->counters_mutex);
-    common->reads_active[name] += 1;
+    pthread_mutex_lock(&(common->threads_mutex));
+    unsigned int threads_failed = common->threads_failed;
+    pthread_mutex_unlock(&(common->threads_mutex));
+
+    return threads_failed;
 }
 
-void common_writes_active_increment(common_t *common, const std::string &name)
+unsigned long common_threads_completed_get(common_t *common)
 {
-    std::lock_guard<std::mutex> lock(common->counters_mutex);
-    common->writes_active[name] += 1;
+    pthread_mutex_lock(&(common->threads_mutex));
+    unsigned long threads_completed = common->threads_completed;
+    pthread_mutex_unlock(&(common->threads_mutex));
+
+    return threads_completed;
 }
 
-void common_comm_name_to_address_create(common_t *common, const std::string& comm_name, char* write_buffer)
+/**
+ * @brief Block until a thread completes a task after threads_completed_seen was read.
+ *
+ * Returns immediately if a completion already happened in between, so reading the counter
+ * before asking the scheduler and waiting afterwards cannot miss a wake-up.
+ *
+ * @return true if a completion happened; false if the deadline expired or there are no
+ *         active threads (i.e., nothing can complete).
+ */
+bool common_threads_completed_wait(common_t *common, unsigned long threads_completed_seen, const struct timespec &deadline)
 {
-    std::lock_guard<std::mutex> lock(common->comm_maps_mutex);
-    common->comm_name_to_address[comm_name] = write_buffer;
+    int rc = 0;
+
+    pthread_mutex_lock(&(common->threads_mutex));
+    while (common->threads_completed == threads_completed_seen && common->threads_active > 0 && rc != ETIMEDOUT)
+        rc = pthread_cond_timedwait(&(common->threads_cond), &(common->threads_mutex), &deadline);
+    bool completed = common->threads_completed != threads_completed_seen;
+    pthread_mutex_unlock(&(common->threads_mutex));
+
+    return completed;
 }
 
-char* common_comm_name_to_address_get(const common_t *common, const std::string& comm_name)
+struct timespec common_deadline_from_now(time_t timeout_s)
 {
-    try {
-        return common->comm_name_to_address.at(comm_name);
-    } catch (const std::out_of_range& e) {
-        XBT_ERROR("Not found comm_name: %s", comm_name.c_str());
-        throw;
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_s;
+
+    return deadline;
+}
+
+/**
+ * @brief Release the successors of a finished exec.
+ *
+ * Decrements the pending dependencies of every exec reached by an out-comm of exec_id,
+ * and pushes to the ready-set the execs whose dependencies are all solved.
+ * Called by the mapper thread functions, possibly from several threads at once.
+ */
+void common_exec_id_set_completed(common_t *common, unsigned int exec_id)
+{
+    pthread_mutex_lock(&(common->execs_ready_mutex));
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(common, exec_id))
+    {
+        unsigned int dst_exec_id = common->workflow.comm_dst_exec_ids[comm_id];
+        if (--common->exec_id_to_deps_pending[dst_exec_id] == 0)
+            common->execs_ready.push_back(dst_exec_id);
     }
+    pthread_mutex_unlock(&(common->execs_ready_mutex));
 }
 
-void common_comm_name_to_numa_ids_r_create(common_t *common, const std::string& comm_name, const std::vector<int>& memory_bindings) {
-    std::lock_guard<std::mutex> lock(common->comm_maps_mutex);
-    common->comm_name_to_numa_ids_r[comm_name] = memory_bindings;
+/**
+ * @brief Release the destination of comm_id once all its dependencies are solved (one comm at a time).
+ */
+void common_comm_id_set_ready(common_t *common, unsigned int comm_id)
+{
+    unsigned int dst_exec_id = common->workflow.comm_dst_exec_ids[comm_id];
+
+    pthread_mutex_lock(&(common->execs_ready_mutex));
+    if (--common->exec_id_to_deps_pending[dst_exec_id] == 0)
+        common->execs_ready.push_back(dst_exec_id);
+    pthread_mutex_unlock(&(common->execs_ready_mutex));
 }
 
-void common_comm_name_to_numa_ids_w_create(common_t *common, const std::string& comm_name, const std::vector<int>& memory_bindings)
+/**
+ * @brief Take the execs that became ready since the previous call.
+ *
+ * @return Newly ready exec ids, in ascending order (i.e., dag order).
+ */
+exec_ids_t common_execs_ready_take(common_t *common)
 {
-    std::lock_guard<std::mutex> lock(common->comm_maps_mutex);
-    common->comm_name_to_numa_ids_w[comm_name] = memory_bindings;
+    exec_ids_t ready_exec_ids;
+
+    pthread_mutex_lock(&(common->execs_ready_mutex));
+    ready_exec_ids.swap(common->execs_ready);
+    pthread_mutex_unlock(&(common->execs_ready_mutex));
+
+    std::sort(ready_exec_ids.begin(), ready_exec_ids.end());
+
+    return ready_exec_ids;
 }
 
-std::vector<int> common_comm_name_to_numa_ids_w_get(const common_t *common, const std::string& comm_name)
+void common_execs_active_increment(common_t *common, unsigned int exec_id)
 {
-    // Assuming common has a mutex member named 'mutex'
-    std::lock_guard<std::mutex> lock(common->comm_maps_mutex);
-    try {
-        return common->comm_name_to_numa_ids_w.at(comm_name);
-    } catch (const std::out_of_range& e) {
-        XBT_ERROR("Not found comm_name: %s", comm_name.c_str());
-        throw;
+    common->execs_active[exec_id] += 1;
+}
+
+void common_reads_active_increment(common_t *common, unsigned int comm_id)
+{
+    common->reads_active[comm_id] += 1;
+
+    // Each data item has a single reader; its bytes are released once read.
+    common_numa_memory_update(common, common_comm_id_to_numa_ids_w_get(common, comm_id), -common->workflow.comm_payloads[comm_id]);
+}
+
+void common_writes_active_increment(common_t *common, unsigned int comm_id)
+{
+    common->writes_active[comm_id] += 1;
+}
+
+static void common_time_range_payload_set(id_to_time_range_payload_t &table, unsigned int id, const time_range_payload_t& time_range_payload)
+{
+    std::tie(table.start[id], table.end[id], table.payload[id]) = time_range_payload;
+    table.recorded[id] = 1;
+}
+
+static bool common_trace_is_binary(const common_t *common)
+{
+    return common->trace_writer.backend == TRACE_BACKEND_BINARY;
+}
+
+static void common_trace_append(common_t *common, trace_record_type_t type, unsigned int id, const time_range_payload_t& time_range_payload)
+{
+    trace_record_t record = {};
+    record.type = type;
+    record.id = id;
+    std::tie(record.start, record.end, record.payload) = time_range_payload;
+    record.core_id = -1;
+    record.numa_id = -1;
+
+    trace_append(common->trace_writer, record);
+}
+
+static void common_trace_append(common_t *common, trace_record_type_t type, unsigned int id, numa_mask_t numa_mask)
+{
+    trace_record_t record = {};
+    record.type = type;
+    record.id = id;
+    record.numa_mask = numa_mask;
+    record.core_id = -1;
+    record.numa_id = -1;
+
+    trace_append(common->trace_writer, record);
+}
+
+// NUMA node of the core assigned to exec_id (-1 if not dispatched or unknown).
+static int common_timeline_numa_id(const common_t *common, unsigned int exec_id)
+{
+    int core_id = common->exec_id_to_core_id[exec_id];
+    const std::vector<int> &core_id_to_numa_id = common->topology_tables.core_id_to_numa_id;
+
+    return (core_id >= 0 && (size_t) core_id < core_id_to_numa_id.size()) ? core_id_to_numa_id[core_id] : -1;
+}
+
+// Slice of a phase of exec_id on the track of its assigned core.
+static void common_timeline_slice(common_t *common, const char *category, unsigned int exec_id, const std::string &name,
+    const time_range_payload_t& time_range_payload, const std::string &args)
+{
+    trace_timeline_slice(common->trace_timeline, category, name, common_timeline_numa_id(common, exec_id), common->exec_id_to_core_id[exec_id],
+        std::get<0>(time_range_payload), std::get<1>(time_range_payload), args);
+}
+
+// Read (or write) slice of a comm, and the end (or start) of its flow; flows go from the start of the write to the start of the read.
+static void common_timeline_comm(common_t *common, bool write, unsigned int comm_id, const time_range_payload_t& time_range_payload)
+{
+    if (!common->trace_timeline.file) return;
+
+    const workflow_t &workflow = common->workflow;
+    unsigned int exec_id = write ? workflow.comm_src_exec_ids[comm_id] : workflow.comm_dst_exec_ids[comm_id];
+    int numa_id = common_timeline_numa_id(common, exec_id);
+
+    std::ostringstream args;
+    args << "\"payload_bytes\": " << std::get<2>(time_range_payload);
+
+    if (!write)
+    {
+        // Remote read: none of the NUMA nodes the data item was written to is the reader's (migrations aside).
+        numa_mask_t numa_mask = common->comm_id_to_numa_ids_w.recorded[comm_id] ? common->comm_id_to_numa_ids_w.numa_mask[comm_id] : 0;
+        bool remote = numa_id >= 0 && numa_mask != 0 && !(numa_mask & ((numa_mask_t) 1 << numa_id));
+
+        args << ", \"src_numa_ids\": [" << common_join(common_numa_mask_to_ids(numa_mask), ", ") << "]"
+             << ", \"remote\": " << (remote ? "true" : "false");
     }
+
+    common_timeline_slice(common, write ? "write" : "read", exec_id, workflow.comm_names[comm_id], time_range_payload, args.str());
+    trace_timeline_flow(common->trace_timeline, write, comm_id, workflow.comm_names[comm_id], numa_id, common->exec_id_to_core_id[exec_id], std::get<0>(time_range_payload));
 }
 
-void common_exec_name_to_thread_locality_create(common_t *common, const std::string& exec_name, const thread_locality_t& locality) {
-    std::lock_guard<std::mutex> lock(common->exec_locality_mutex);
-    common->exec_name_to_thread_locality[exec_name] = locality;
+static time_range_payload_t common_time_range_payload_get(const id_to_time_range_payload_t &table, unsigned int id, const std::string &name)
+{
+    if (!table.recorded[id])
+    {
+        XBT_ERROR("Not found: %s", name.c_str());
+        throw std::out_of_range("Not found: " + name);
+    }
+
+    return {table.start[id], table.end[id], table.payload[id]};
 }
 
-void common_comm_name_to_r_ts_range_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->timestamp_mutex);
-    common->comm_name_to_r_ts_range_payload[comm_name] = time_range_payload;
+void common_comm_id_to_address_create(common_t *common, unsigned int comm_id, char* write_buffer)
+{
+    common->comm_id_to_address[comm_id] = write_buffer;
 }
 
-void common_comm_name_to_w_ts_range_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->timestamp_mutex);
-    common->comm_name_to_w_ts_range_payload[comm_name] = time_range_payload;
+char* common_comm_id_to_address_get(const common_t *common, unsigned int comm_id)
+{
+    return common->comm_id_to_address[comm_id];
 }
 
-void common_exec_name_to_c_ts_range_payload_create(common_t *common, const std::string& exec_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->timestamp_mutex);
-    common->exec_name_to_c_ts_range_payload[exec_name] = time_range_payload;
+void common_comm_id_to_numa_ids_r_create(common_t *common, unsigned int comm_id, const std::vector<int>& memory_bindings) {
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_NUMA_READ, comm_id, common_numa_ids_to_mask(memory_bindings));
+
+    common->comm_id_to_numa_ids_r.numa_mask[comm_id] = common_numa_ids_to_mask(memory_bindings);
+    common->comm_id_to_numa_ids_r.recorded[comm_id] = 1;
 }
 
-void common_comm_name_to_r_time_offset_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->offset_mutex);
-    common->comm_name_to_r_time_offset_payload[comm_name] = time_range_payload;
+void common_comm_id_to_numa_ids_w_create(common_t *common, unsigned int comm_id, const std::vector<int>& memory_bindings)
+{
+    common->comm_id_to_numa_ids_w.numa_mask[comm_id] = common_numa_ids_to_mask(memory_bindings);
+    common->comm_id_to_numa_ids_w.recorded[comm_id] = 1;
+
+    if (common_trace_is_binary(common))
+        common_trace_append(common, TRACE_RECORD_NUMA_WRITE, comm_id, common->comm_id_to_numa_ids_w.numa_mask[comm_id]);
+
+    // The data item is resident on the written NUMA nodes until it is read.
+    common_numa_memory_update(common, common->comm_id_to_numa_ids_w.numa_mask[comm_id], common->workflow.comm_payloads[comm_id]);
 }
 
-void common_comm_name_to_w_time_offset_payload_create(common_t *common, const std::string& comm_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->offset_mutex);
-    common->comm_name_to_w_time_offset_payload[comm_name] = time_range_payload;
+numa_mask_t common_comm_id_to_numa_ids_w_get(const common_t *common, unsigned int comm_id)
+{
+    if (!common->comm_id_to_numa_ids_w.recorded[comm_id])
+    {
+        XBT_ERROR("Not found comm_name: %s", common->workflow.comm_names[comm_id].c_str());
+        throw std::out_of_range("Not found comm_name: " + common->workflow.comm_names[comm_id]);
+    }
+
+    return common->comm_id_to_numa_ids_w.numa_mask[comm_id];
 }
 
-void common_exec_name_to_c_time_offset_payload_create(common_t *common, const std::string& exec_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->offset_mutex);
-    common->exec_name_to_c_time_offset_payload[exec_name] = time_range_payload;
+void common_exec_id_to_core_id_create(common_t *common, unsigned int exec_id, int core_id)
+{
+    common->exec_id_to_core_id[exec_id] = core_id;
 }
 
-void common_exec_name_to_rcw_time_offset_payload_create(common_t *common, const std::string& exec_name, const time_range_payload_t& time_range_payload) {
-    std::lock_guard<std::mutex> lock(common->offset_mutex);
-    common->exec_name_to_rcw_time_offset_payload[exec_name] = time_range_payload;
+void common_exec_id_to_thread_locality_create(common_t *common, unsigned int exec_id, const thread_locality_t& locality) {
+    if (common_trace_is_binary(common))
+    {
+        trace_record_t record = {};
+        record.type = TRACE_RECORD_THREAD_LOCALITY;
+        record.id = exec_id;
+        record.start = locality.voluntary_context_switches;
+        record.end = locality.involuntary_context_switches;
+        record.payload = locality.core_migrations;
+        record.core_id = locality.core_id;
+        record.numa_id = locality.numa_id;
+
+        return trace_append(common->trace_writer, record);
+    }
+
+    common->exec_id_to_thread_locality.locality[exec_id] = locality;
+    common->exec_id_to_thread_locality.recorded[exec_id] = 1;
 }
 
-time_range_payload_t common_exec_name_to_rcw_time_offset_payload_get(const common_t *common, const std::string& exec_name)
+void common_exec_id_to_perf_counters_create(common_t *common, unsigned int exec_id, phase_type_t phase, const std::vector<double>& values)
 {
-    std::lock_guard<std::mutex> lock(common->offset_mutex);
-    try {
-        return common->exec_name_to_rcw_time_offset_payload.at(exec_name);
-    } catch (const std::out_of_range& e) {
-        XBT_ERROR("Not found exec_name: %s", exec_name.c_str());
-        throw;
+    id_to_perf_counters_t &mapping = common->exec_id_to_perf_counters;
+
+    if (common_trace_is_binary(common))
+    {
+        trace_record_t record = {};
+        record.type = TRACE_RECORD_PERF_COUNTER;
+        record.phase = phase;
+        record.id = exec_id;
+        record.core_id = -1;
+        record.numa_id = -1;
+
+        for (size_t i = 0; i < mapping.counters_count; ++i)
+        {
+            record.counter = i;
+            record.payload = values[i];
+            trace_append(common->trace_writer, record);
+        }
+        return;
+    }
+
+    std::copy(values.begin(), values.begin() + mapping.counters_count,
+        mapping.values.begin() + (exec_id * COMMON_PHASES_COUNT + phase) * mapping.counters_count);
+    mapping.recorded[exec_id] = 1;
+}
+
+void common_comm_id_to_r_ts_range_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload) {
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_READ_TIMESTAMP, comm_id, time_range_payload);
+
+    common_time_range_payload_set(common->comm_id_to_r_ts_range_payload, comm_id, time_range_payload);
+}
+
+void common_comm_id_to_w_ts_range_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload) {
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_WRITE_TIMESTAMP, comm_id, time_range_payload);
+
+    common_time_range_payload_set(common->comm_id_to_w_ts_range_payload, comm_id, time_range_payload);
+}
+
+void common_exec_id_to_c_ts_range_payload_create(common_t *common, unsigned int exec_id, const time_range_payload_t& time_range_payload) {
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_COMPUTE_TIMESTAMP, exec_id, time_range_payload);
+
+    common_time_range_payload_set(common->exec_id_to_c_ts_range_payload, exec_id, time_range_payload);
+}
+
+void common_comm_id_to_r_time_offset_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload) {
+    common_timeline_comm(common, false, comm_id, time_range_payload);
+
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_READ_OFFSET, comm_id, time_range_payload);
+
+    common_time_range_payload_set(common->comm_id_to_r_time_offset_payload, comm_id, time_range_payload);
+}
+
+void common_comm_id_to_w_time_offset_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload) {
+    common_timeline_comm(common, true, comm_id, time_range_payload);
+
+    common_time_range_payload_set(common->comm_id_to_w_time_offset_payload, comm_id, time_range_payload);
+
+    if (common_trace_is_binary(common))
+        common_trace_append(common, TRACE_RECORD_WRITE_OFFSET, comm_id, time_range_payload);
+}
+
+time_range_payload_t common_comm_id_to_w_time_offset_payload_get(const common_t *common, unsigned int comm_id)
+{
+    return common_time_range_payload_get(common->comm_id_to_w_time_offset_payload, comm_id, common->workflow.comm_names[comm_id]);
+}
+
+void common_exec_id_to_c_time_offset_payload_create(common_t *common, unsigned int exec_id, const time_range_payload_t& time_range_payload) {
+    if (common->trace_timeline.file)
+    {
+        std::ostringstream args;
+        args << "\"flops\": " << std::get<2>(time_range_payload);
+        common_timeline_slice(common, "compute", exec_id, common->workflow.exec_names[exec_id], time_range_payload, args.str());
     }
+
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_COMPUTE_OFFSET, exec_id, time_range_payload);
+
+    common_time_range_payload_set(common->exec_id_to_c_time_offset_payload, exec_id, time_range_payload);
+}
+
+void common_exec_id_to_rcw_time_offset_payload_create(common_t *common, unsigned int exec_id, const time_range_payload_t& time_range_payload) {
+    common_time_range_payload_set(common->exec_id_to_rcw_time_offset_payload, exec_id, time_range_payload);
+
+    if (common_trace_is_binary(common))
+        common_trace_append(common, TRACE_RECORD_TOTAL_OFFSET, exec_id, time_range_payload);
+}
+
+time_range_payload_t common_exec_id_to_rcw_time_offset_payload_get(const common_t *common, unsigned int exec_id)
+{
+    return common_time_range_payload_get(common->exec_id_to_rcw_time_offset_payload, exec_id, common->workflow.exec_names[exec_id]);
+}
+
+void common_comm_id_to_m_time_offset_payload_create(common_t *common, unsigned int comm_id, const time_range_payload_t& time_range_payload) {
+    if (common_trace_is_binary(common))
+        return common_trace_append(common, TRACE_RECORD_MIGRATION_OFFSET, comm_id, time_range_payload);
+
+    common_time_range_payload_set(common->comm_id_to_m_time_offset_payload, comm_id, time_range_payload);
 }
 
 /* OUTPUT */
@@ -516,7 +1559,11 @@ void common_print_common_structure(const common_t *common, int indent = 0)
     common_print_user(common, out, indent);
     common_print_workflow(common, out, indent);
     common_print_runtime(common, out, indent);
-    common_print_trace(common, out, indent);
+    common_print_scheduler_stats(common, out, indent);
+
+    // The binary trace is written as the run progresses (see tools/trace_to_yaml.py).
+    if (!common_trace_is_binary(common))
+        common_print_trace(common, out, indent);
 
     out.close();
 }
@@ -529,6 +1576,15 @@ void common_print_user(const common_t *common, std::ostream &out, int indent = 0
     
     out << indent_str << "user" << ":\n";
     out << indent_str1 << "flops_per_cycle: " << common->flops_per_cycle << "\n";
+
+    if (!common->core_id_to_flops_per_cycle.empty())
+    {
+        out << indent_str1 << "flops_per_cycle_calibrated:\n";
+        for (size_t i = 0; i < common->core_id_to_flops_per_cycle.size(); ++i)
+            if (common->core_avail[i])
+                out << indent_str2 << i << ": " << common->core_id_to_flops_per_cycle[i] << "\n";
+    }
+
     out << indent_str1 << "clock_frequency_type: " << common_clock_frequency_type_to_str(common->clock_frequency_type) << "\n";
 
     if (!common->clock_frequencies_hz.empty())
@@ -571,9 +1627,9 @@ void common_print_workflow(const common_t *common, std::ostream &out, int indent
     std::string indent_str1(indent + 2, ' ');
     
     out << indent_str << "workflow" << ":\n";
-    out << indent_str1 << "execs_count: " << common->execs_active.size() << "\n";
-    out << indent_str1 << "reads_count: " << common->reads_active.size() << "\n";
-    out << indent_str1 << "writes_count: " << common->writes_active.size() << "\n";
+    out << indent_str1 << "execs_count: " << common->workflow.exec_names.size() << "\n";
+    out << indent_str1 << "reads_count: " << common->workflow.comm_names.size() << "\n";
+    out << indent_str1 << "writes_count: " << common->workflow.comm_names.size() << "\n";
     out << std::endl;
 }
 
@@ -586,9 +1642,9 @@ void common_print_runtime(const common_t *common, std::ostream &out, int indent
     out << indent_str << "runtime" << ":\n";
     out << indent_str1 << "threads_checksum: " << common->threads_checksum << "\n";
     out << indent_str1 << "threads_active: " << common->threads_active << "\n";
-    out << indent_str1 << "tasks_active_count: " << common_name_to_count_get(common->execs_active) << "\n";
-    out << indent_str1 << "reads_active_count: " << common_name_to_count_get(common->reads_active) << "\n";
-    out << indent_str1 << "writes_active_count: " << common_name_to_count_get(common->writes_active) << "\n";
+    out << indent_str1 << "tasks_active_count: " << common_id_to_count_get(common->execs_active) << "\n";
+    out << indent_str1 << "reads_active_count: " << common_id_to_count_get(common->reads_active) << "\n";
+    out << indent_str1 << "writes_active_count: " << common_id_to_count_get(common->writes_active) << "\n";
 
     if (!common->core_avail.empty())
     {
@@ -601,37 +1657,95 @@ void common_print_runtime(const common_t *common, std::ostream &out, int indent
             }        
         }
     }
+
+    if (!common->numa_id_to_resident_bytes.empty())
+    {
+        out << indent_str1 << "numa_memory:\n";
+        for (size_t i = 0; i < common->numa_id_to_resident_bytes.size(); ++i)
+        {
+            out << indent_str2 << i << ": {capacity_bytes: " << common->numa_id_to_capacity_bytes[i]
+                << ", budget_bytes: " << common_numa_id_get_budget_bytes(common, i)
+                << ", resident_bytes: " << common->numa_id_to_resident_bytes[i]
+                << ", peak_resident_bytes: " << common->numa_id_to_peak_resident_bytes[i] << "}\n";
+        }
+    }
+    out << std::endl;
+}
+
+void common_print_scheduler_stats(const common_t *common, std::ostream &out, int indent = 0)
+{
+    const scheduler_stats_t &stats = common->scheduler_stats;
+    if (stats.next_times_us.empty()) return;
+
+    std::string indent_str(indent, ' ');
+    std::string indent_str1(indent + 2, ' ');
+
+    out << indent_str << "scheduler_stats" << ":\n";
+    common_print_stats(stats.next_times_us, "next_us", out, indent + 2);
+    common_print_stats(stats.best_core_times_us, "get_best_core_id_us", out, indent + 2);
+    common_print_stats(stats.cores_evaluated, "cores_evaluated", out, indent + 2);
+    common_print_stats(stats.execs_evaluated, "execs_evaluated", out, indent + 2);
+
+    if (stats.charge_decision_time)
+        out << indent_str1 << "decision_time_charged_us: " << stats.decision_clock_us << "\n";
+
     out << std::endl;
 }
 
+// Total and (nearest-rank) percentiles of a set of samples; nothing is printed if there are none.
+void common_print_stats(const std::vector<double> &samples, const std::string &key, std::ostream &out, int indent = 0)
+{
+    if (samples.empty()) return;
+
+    std::string indent_str(indent, ' ');
+
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&sorted](double q) { return sorted[(size_t) std::ceil(q * sorted.size()) - 1]; };
+
+    out << indent_str << key << ": {count: " << sorted.size()
+        << ", total: " << std::accumulate(sorted.begin(), sorted.end(), 0.0)
+        << ", p50: " << percentile(0.50) << ", p99: " << percentile(0.99) << ", max: " << sorted.back() << "}\n";
+}
+
 void common_print_trace(const common_t *common, std::ostream &out, int indent = 0)
 {
     std::string indent_str(indent, ' ');
     
     out << indent_str << "trace" << ":\n";
-    common_print_name_to_thread_locality(common->exec_name_to_thread_locality, out, indent + 2);
-    common_print_name_to_numa_ids(common->comm_name_to_numa_ids_w, "numa_mappings_write", out, indent + 2);
-    common_print_name_to_numa_ids(common->comm_name_to_numa_ids_r, "numa_mappings_read", out, indent + 2);
-    common_print_name_to_time_range_payload(common->comm_name_to_r_ts_range_payload, "comm_name_read_timestamps", out, indent + 2);
-    common_print_name_to_time_range_payload(common->comm_name_to_w_ts_range_payload, "comm_name_write_timestamps", out, indent + 2);
-    common_print_name_to_time_range_payload(common->exec_name_to_c_ts_range_payload, "exec_name_compute_timestamps", out, indent + 2);
-    common_print_name_to_time_range_payload(common->comm_name_to_r_time_offset_payload, "comm_name_read_offsets", out, indent + 2);
-    common_print_name_to_time_range_payload(common->comm_name_to_w_time_offset_payload, "comm_name_write_offsets", out, indent + 2);
-    common_print_name_to_time_range_payload(common->exec_name_to_c_time_offset_payload, "exec_name_compute_offsets", out, indent + 2);
-    common_print_name_to_time_range_payload(common->exec_name_to_rcw_time_offset_payload, "exec_name_total_offsets", out, indent + 2);
+
+    const std::vector<std::string> &exec_names = common->workflow.exec_names;
+    const std::vector<std::string> &comm_names = common->workflow.comm_names;
+
+    common_print_id_to_thread_locality(exec_names, common->exec_id_to_thread_locality, out, indent + 2);
+    common_print_id_to_perf_counters(common, exec_names, common->exec_id_to_perf_counters, out, indent + 2);
+    common_print_id_to_numa_ids(comm_names, common->comm_id_to_numa_ids_w, "numa_mappings_write", out, indent + 2);
+    common_print_id_to_numa_ids(comm_names, common->comm_id_to_numa_ids_r, "numa_mappings_read", out, indent + 2);
+    common_print_id_to_time_range_payload(comm_names, common->comm_id_to_r_ts_range_payload, "comm_name_read_timestamps", out, indent + 2);
+    common_print_id_to_time_range_payload(comm_names, common->comm_id_to_w_ts_range_payload, "comm_name_write_timestamps", out, indent + 2);
+    common_print_id_to_time_range_payload(exec_names, common->exec_id_to_c_ts_range_payload, "exec_name_compute_timestamps", out, indent + 2);
+    common_print_id_to_time_range_payload(comm_names, common->comm_id_to_r_time_offset_payload, "comm_name_read_offsets", out, indent + 2);
+    common_print_id_to_time_range_payload(comm_names, common->comm_id_to_w_time_offset_payload, "comm_name_write_offsets", out, indent + 2);
+    common_print_id_to_time_range_payload(comm_names, common->comm_id_to_m_time_offset_payload, "comm_name_migration_offsets", out, indent + 2);
+    common_print_id_to_time_range_payload(exec_names, common->exec_id_to_c_time_offset_payload, "exec_name_compute_offsets", out, indent + 2);
+    common_print_id_to_time_range_payload(exec_names, common->exec_id_to_rcw_time_offset_payload, "exec_name_total_offsets", out, indent + 2);
 }
 
-void common_print_name_to_thread_locality(const name_to_thread_locality_t &mapping, std::ostream &out, int indent = 0)
+void common_print_id_to_thread_locality(const std::vector<std::string> &names, const id_to_thread_locality_t &mapping, std::ostream &out, int indent = 0)
 {
-    if (mapping.empty()) return;
+    if (std::find(mapping.recorded.begin(), mapping.recorded.end(), 1) == mapping.recorded.end()) return;
 
     std::string indent_str(indent, ' ');
     std::string indent_str1(indent + 2, ' ');
     
     out << indent_str << "name_to_thread_locality:\n";
-    for (const auto &[key, loc] : mapping)
+    for (size_t id = 0; id < names.size(); ++id)
     {
-        out << indent_str1 << key << ": {numa_id: " << loc.numa_id << ", core_id: " << loc.core_id
+        if (!mapping.recorded[id]) continue;
+
+        const thread_locality_t &loc = mapping.locality[id];
+        out << indent_str1 << names[id] << ": {numa_id: " << loc.numa_id << ", core_id: " << loc.core_id
             << ", voluntary_cs: " << loc.voluntary_context_switches
             << ", involuntary_cs: " << loc.involuntary_context_switches << ", core_migrations: " << loc.core_migrations
             << "}\n";
@@ -639,48 +1753,72 @@ void common_print_name_to_thread_locality(const name_to_thread_locality_t &mappi
     out << std::endl;
 }
 
-void common_print_name_to_numa_ids(const name_to_numa_ids_t &mapping, const std::string header, std::ostream &out, int indent = 0)
+void common_print_id_to_perf_counters(const common_t *common, const std::vector<std::string> &names, const id_to_perf_counters_t &mapping, std::ostream &out, int indent = 0)
 {
-    if (mapping.empty()) return;
+    if (std::find(mapping.recorded.begin(), mapping.recorded.end(), 1) == mapping.recorded.end()) return;
 
     std::string indent_str(indent, ' ');
     std::string indent_str1(indent + 2, ' ');
-    
-    out << indent_str << header << ":\n";
-    for (const auto &[key, values] : mapping)
+
+    out << indent_str << "perf_counters_source: " << common_perf_counters_type_to_str(common->perf_counters_type) << "\n";
+    out << indent_str << "exec_name_perf_counters:\n";
+    for (size_t id = 0; id < names.size(); ++id)
     {
-        out << indent_str1 << key << ": {numa_ids: [";
-        for (auto it = values.begin(); it != values.end(); ++it)
+        if (!mapping.recorded[id]) continue;
+
+        out << indent_str1 << names[id] << ": {";
+        for (int phase = 0; phase < COMMON_PHASES_COUNT; ++phase)
         {
-            if (it != values.begin())
-                out << ", ";
-            out << *it;
+            const double *values = &(mapping.values[(id * COMMON_PHASES_COUNT + phase) * mapping.counters_count]);
+
+            out << (phase ? ", " : "") << common_phase_type_to_str((phase_type_t) phase) << ": {";
+            for (size_t i = 0; i < mapping.counters_count; ++i)
+                out << (i ? ", " : "") << common->perf_counter_names[i] << ": " << (unsigned long long) values[i];
+            out << "}";
         }
-        out << "]}\n";
+        out << "}\n";
     }
     out << std::endl;
 }
 
-void common_print_name_to_time_range_payload(const name_to_time_range_payload_t &mapping, const std::string &header, std::ostream &out, int indent = 0)
+void common_print_id_to_numa_ids(const std::vector<std::string> &names, const id_to_numa_ids_t &mapping, const std::string header, std::ostream &out, int indent = 0)
 {
-    if (mapping.empty()) return;
+    if (std::find(mapping.recorded.begin(), mapping.recorded.end(), 1) == mapping.recorded.end()) return;
 
     std::string indent_str(indent, ' ');
     std::string indent_str1(indent + 2, ' ');
     
     out << indent_str << header << ":\n";
-    for (const auto &[key, value] : mapping)
+    for (size_t id = 0; id < names.size(); ++id)
     {
-        auto [start, end, bytes] = value;
-        out << indent_str1 << key << ": {start: " << start << ", end: " << end << ", payload: " << bytes << "}\n";
+        if (!mapping.recorded[id]) continue;
+
+        out << indent_str1 << names[id] << ": {numa_ids: [" << common_join(common_numa_mask_to_ids(mapping.numa_mask[id]), ", ") << "]}\n";
+    }
+    out << std::endl;
+}
+
+void common_print_id_to_time_range_payload(const std::vector<std::string> &names, const id_to_time_range_payload_t &mapping, const std::string &header, std::ostream &out, int indent = 0)
+{
+    if (std::find(mapping.recorded.begin(), mapping.recorded.end(), 1) == mapping.recorded.end()) return;
+
+    std::string indent_str(indent, ' ');
+    std::string indent_str1(indent + 2, ' ');
+    
+    out << indent_str << header << ":\n";
+    for (size_t id = 0; id < names.size(); ++id)
+    {
+        if (!mapping.recorded[id]) continue;
+
+        out << indent_str1 << names[id] << ": {start: " << mapping.start[id] << ", end: " << mapping.end[id] << ", payload: " << mapping.payload[id] << "}\n";
     }
     out << std::endl;
 }
 
 /* OUTPUT UTILS */
-size_t common_name_to_count_get(const name_to_count_t &mapping) {
+size_t common_id_to_count_get(const id_to_count_t &mapping) {
     size_t total = 0;
-    for (const auto &[name, count] : mapping) {
+    for (unsigned int count : mapping) {
         total += count;
     }
     return total;
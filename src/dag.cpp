@@ -0,0 +1,195 @@
+#include "dag.hpp"
+
+#include <xbt/log.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(dag, "Messages specific to this module.");
+
+static_assert(sizeof(unsigned int) == sizeof(uint32_t), "workflow ids are written as uint32_t.");
+
+static size_t dag_file_bytes(uint64_t execs_count, uint64_t comms_count, uint64_t names_bytes)
+{
+    return sizeof(dag_header_t)
+        + (execs_count + comms_count) * sizeof(double)
+        + (execs_count + 1 + comms_count + 1) * sizeof(uint64_t)
+        + (execs_count + 1 + comms_count) * sizeof(uint32_t)
+        + names_bytes;
+}
+
+bool dag_file_is_binary(const std::string &file_name)
+{
+    const std::string extension = DAG_FILE_EXTENSION;
+    return file_name.size() >= extension.size() &&
+        file_name.compare(file_name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+ * @brief Map a binary DAG file read-only and set the section pointers.
+ */
+void dag_open(dag_file_t &dag, const std::string &file_name)
+{
+    dag.file_name = file_name;
+    dag.base = nullptr;
+
+    dag.fd = open(file_name.c_str(), O_RDONLY);
+    if (dag.fd < 0)
+    {
+        XBT_ERROR("Failed to open dag file '%s': %s", file_name.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to open dag file '" + file_name + "'.");
+    }
+
+    struct stat st;
+    if (fstat(dag.fd, &st) != 0 || (size_t) st.st_size < sizeof(dag_header_t))
+    {
+        close(dag.fd);
+        XBT_ERROR("Invalid dag file '%s'.", file_name.c_str());
+        throw std::runtime_error("Invalid dag file '" + file_name + "'.");
+    }
+
+    dag.size = st.st_size;
+    void *base = mmap(nullptr, dag.size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, dag.fd, 0);
+    if (base == MAP_FAILED)
+    {
+        close(dag.fd);
+        XBT_ERROR("Failed to map dag file '%s': %s", file_name.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to map dag file '" + file_name + "'.");
+    }
+
+    dag.base = (const char *) base;
+    dag.header = (const dag_header_t *) dag.base;
+
+    const dag_header_t *header = dag.header;
+    if (memcmp(header->magic, DAG_MAGIC, sizeof(header->magic)) != 0 || header->version != DAG_VERSION ||
+        dag.size != dag_file_bytes(header->execs_count, header->comms_count, header->names_bytes))
+    {
+        dag_close(dag);
+        XBT_ERROR("'%s' is not a version %d nflows dag file.", file_name.c_str(), DAG_VERSION);
+        throw std::runtime_error("Invalid dag file '" + file_name + "'.");
+    }
+
+    const char *section = dag.base + sizeof(dag_header_t);
+
+    dag.exec_flops = (const double *) section;
+    section += header->execs_count * sizeof(double);
+    dag.comm_payloads = (const double *) section;
+    section += header->comms_count * sizeof(double);
+    dag.exec_name_offsets = (const uint64_t *) section;
+    section += (header->execs_count + 1) * sizeof(uint64_t);
+    dag.comm_name_offsets = (const uint64_t *) section;
+    section += (header->comms_count + 1) * sizeof(uint64_t);
+    dag.exec_out_offsets = (const uint32_t *) section;
+    section += (header->execs_count + 1) * sizeof(uint32_t);
+    dag.comm_dst_exec_ids = (const uint32_t *) section;
+    section += header->comms_count * sizeof(uint32_t);
+    dag.names = section;
+
+    // Ids and offsets are used as indexes by the workflow tables.
+    bool valid = dag.exec_out_offsets[0] == 0 && dag.exec_out_offsets[header->execs_count] == header->comms_count &&
+        dag.exec_name_offsets[header->execs_count] <= header->names_bytes && dag.comm_name_offsets[header->comms_count] <= header->names_bytes;
+
+    for (uint64_t exec_id = 0; valid && exec_id < header->execs_count; ++exec_id)
+        valid = dag.exec_out_offsets[exec_id] <= dag.exec_out_offsets[exec_id + 1] && dag.exec_name_offsets[exec_id] <= dag.exec_name_offsets[exec_id + 1];
+
+    for (uint64_t comm_id = 0; valid && comm_id < header->comms_count; ++comm_id)
+        valid = dag.comm_dst_exec_ids[comm_id] < header->execs_count && dag.comm_name_offsets[comm_id] <= dag.comm_name_offsets[comm_id + 1];
+
+    if (!valid)
+    {
+        dag_close(dag);
+        XBT_ERROR("Corrupted dag file '%s'.", file_name.c_str());
+        throw std::runtime_error("Corrupted dag file '" + file_name + "'.");
+    }
+
+    XBT_INFO("Dag file: %s (execs: %zu, comms: %zu)", file_name.c_str(), (size_t) header->execs_count, (size_t) header->comms_count);
+}
+
+void dag_close(dag_file_t &dag)
+{
+    if (dag.base == nullptr) return;
+
+    munmap((void *) dag.base, dag.size);
+    close(dag.fd);
+
+    dag.base = nullptr;
+    dag.fd = -1;
+}
+
+std::string dag_exec_name(const dag_file_t &dag, size_t exec_id)
+{
+    return std::string(dag.names + dag.exec_name_offsets[exec_id], dag.exec_name_offsets[exec_id + 1] - dag.exec_name_offsets[exec_id]);
+}
+
+std::string dag_comm_name(const dag_file_t &dag, size_t comm_id)
+{
+    return std::string(dag.names + dag.comm_name_offsets[comm_id], dag.comm_name_offsets[comm_id + 1] - dag.comm_name_offsets[comm_id]);
+}
+
+template <typename T>
+static void dag_write_section(std::ofstream &file, const std::vector<T> &values)
+{
+    file.write((const char *) values.data(), values.size() * sizeof(T));
+}
+
+static std::vector<uint64_t> dag_names_append(std::string &names, const std::vector<std::string> &strs)
+{
+    std::vector<uint64_t> offsets(1, names.size());
+    for (const std::string &str : strs)
+    {
+        names.append(str);
+        offsets.push_back(names.size());
+    }
+
+    return offsets;
+}
+
+/**
+ * @brief Write a binary DAG file; comm_ids must be numbered by source exec (as common_workflow_initialize does).
+ */
+void dag_write(const std::string &file_name, const std::vector<std::string> &exec_names, const std::vector<double> &exec_flops,
+    const std::vector<unsigned int> &exec_out_offsets, const std::vector<unsigned int> &comm_dst_exec_ids,
+    const std::vector<std::string> &comm_names, const std::vector<double> &comm_payloads)
+{
+    std::string names;
+    std::vector<uint64_t> exec_name_offsets = dag_names_append(names, exec_names);
+    std::vector<uint64_t> comm_name_offsets = dag_names_append(names, comm_names);
+
+    dag_header_t header = {};
+    memcpy(header.magic, DAG_MAGIC, sizeof(header.magic));
+    header.version = DAG_VERSION;
+    header.execs_count = exec_names.size();
+    header.comms_count = comm_names.size();
+    header.names_bytes = names.size();
+
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        XBT_ERROR("Failed to open dag file '%s'.", file_name.c_str());
+        throw std::runtime_error("Failed to open dag file '" + file_name + "'.");
+    }
+
+    file.write((const char *) &header, sizeof(header));
+    dag_write_section(file, exec_flops);
+    dag_write_section(file, comm_payloads);
+    dag_write_section(file, exec_name_offsets);
+    dag_write_section(file, comm_name_offsets);
+    dag_write_section(file, exec_out_offsets);
+    dag_write_section(file, comm_dst_exec_ids);
+    file.write(names.data(), names.size());
+
+    if (!file.good())
+    {
+        XBT_ERROR("Failed to write dag file '%s'.", file_name.c_str());
+        throw std::runtime_error("Failed to write dag file '" + file_name + "'.");
+    }
+
+    XBT_INFO("Dag file: %s (execs: %zu, comms: %zu)", file_name.c_str(), exec_names.size(), comm_names.size());
+}
@@ -2,27 +2,127 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(hardware, "Messages specific to this module.");
 
-int hardware_hwloc_core_id_get_by_pu_id(const common_t *common, int os_pu_id)
+static void *hardware_hwloc_alloc_on_numa_id(const common_t *common, size_t size, int numa_id);
+
+/**
+ * @brief Build the topology lookup tables (core/PU/NUMA/L3) from the loaded hwloc topology.
+ *
+ * Query functions index these tables instead of traversing the hwloc topology on every call.
+ */
+void hardware_hwloc_topology_tables_initialize(common_t *common)
 {
-    // Get the PU object by its OS index (sched_getcpu() index)
-    hwloc_obj_t pu_obj = hwloc_get_pu_obj_by_os_index(common->topology, os_pu_id);
-    if (pu_obj == nullptr)
+    topology_tables_t &tables = common->topology_tables;
+
+    int core_count = hwloc_get_nbobjs_by_type(common->topology, HWLOC_OBJ_CORE);
+    int numa_count = hwloc_get_nbobjs_by_type(common->topology, HWLOC_OBJ_NUMANODE);
+    int pu_count = hwloc_get_nbobjs_by_type(common->topology, HWLOC_OBJ_PU);
+
+    tables.core_id_to_numa_id.assign(core_count, -1);
+    tables.core_id_to_pu_os_id.assign(core_count, -1);
+    tables.core_id_to_l3_id.assign(core_count, -1);
+    tables.numa_id_to_core_ids.assign(std::max(numa_count, 0), std::vector<int>());
+
+    // PU os indexes may be sparse.
+    int max_pu_os_id = -1;
+    for (int pu_id = 0; pu_id < pu_count; ++pu_id)
+        max_pu_os_id = std::max(max_pu_os_id, (int) hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_PU, pu_id)->os_index);
+
+    tables.pu_os_id_to_core_id.assign(max_pu_os_id + 1, -1);
+
+    for (int hwloc_core_id = 0; hwloc_core_id < core_count; ++hwloc_core_id)
     {
-        XBT_ERROR("hwloc_pu_object not found for os_pu_id: %d", os_pu_id);
-        throw std::runtime_error("hwloc_pu_object not found for os_pu_id: " + std::to_string(os_pu_id));
+        hwloc_obj_t core_obj = hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_CORE, hwloc_core_id);
+
+        // NUMA node whose cpuset includes the core cpuset.
+        hwloc_cpuset_t cpuset = hwloc_bitmap_dup(core_obj->cpuset);
+
+        hwloc_obj_t numa_node = NULL;
+        int hwloc_numa_id = -1;
+        while ((numa_node = hwloc_get_next_obj_covering_cpuset_by_type(common->topology, cpuset, HWLOC_OBJ_NUMANODE, numa_node)) != NULL)
+            if (hwloc_bitmap_isincluded(cpuset, numa_node->cpuset))
+                hwloc_numa_id = numa_node->logical_index;
+
+        hwloc_bitmap_free(cpuset);
+
+        tables.core_id_to_numa_id[hwloc_core_id] = hwloc_numa_id;
+        if (hwloc_numa_id != -1)
+            tables.numa_id_to_core_ids[hwloc_numa_id].push_back(hwloc_core_id);
+
+        // First PU of the core (the one kept by hwloc_bitmap_singlify).
+        tables.core_id_to_pu_os_id[hwloc_core_id] = hwloc_bitmap_first(core_obj->cpuset);
+
+        int pu_os_id;
+        hwloc_bitmap_foreach_begin(pu_os_id, core_obj->cpuset)
+        {
+            if (pu_os_id <= max_pu_os_id)
+                tables.pu_os_id_to_core_id[pu_os_id] = hwloc_core_id;
+        }
+        hwloc_bitmap_foreach_end();
+
+        hwloc_obj_t l3_obj = hwloc_get_ancestor_obj_by_type(common->topology, HWLOC_OBJ_L3CACHE, core_obj);
+        if (l3_obj)
+            tables.core_id_to_l3_id[hwloc_core_id] = l3_obj->logical_index;
     }
 
-    // Get the core that contains this PU
-    hwloc_obj_t core_obj = hwloc_get_ancestor_obj_by_type(common->topology, HWLOC_OBJ_CORE, pu_obj);
-    if (core_obj == nullptr)
+    // Memory capacity of each NUMA node.
+    tables.numa_id_to_local_memory_bytes.assign(std::max(numa_count, 0), 0.0);
+    for (int hwloc_numa_id = 0; hwloc_numa_id < numa_count; ++hwloc_numa_id)
+        tables.numa_id_to_local_memory_bytes[hwloc_numa_id] =
+            (double) hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_NUMANODE, hwloc_numa_id)->attr->numanode.local_memory;
+
+    XBT_DEBUG("topology_tables: cores: %d, numa_nodes: %d, pus: %d", core_count, numa_count, pu_count);
+}
+
+int hardware_hwloc_core_id_get_by_pu_id(const common_t *common, int os_pu_id)
+{
+    const std::vector<int> &pu_os_id_to_core_id = common->topology_tables.pu_os_id_to_core_id;
+
+    if (os_pu_id < 0 || (size_t) os_pu_id >= pu_os_id_to_core_id.size() || pu_os_id_to_core_id[os_pu_id] == -1)
     {
         XBT_ERROR("hwloc_core_object not found for os_pu_id: %d", os_pu_id);
         throw std::runtime_error("hwloc_core_object not found for os_pu_id: " + std::to_string(os_pu_id));
     }
 
-    int hwloc_core_id = core_obj->logical_index;
+    return pu_os_id_to_core_id[os_pu_id];
+}
+
+int hardware_hwloc_pu_id_get_by_core_id(const common_t *common, int hwloc_core_id)
+{
+    const std::vector<int> &core_id_to_pu_os_id = common->topology_tables.core_id_to_pu_os_id;
 
-    return hwloc_core_id;
+    if (hwloc_core_id < 0 || (size_t) hwloc_core_id >= core_id_to_pu_os_id.size())
+    {
+        XBT_ERROR("hwloc_core_id not found: %d ", hwloc_core_id);
+        throw std::runtime_error("hwloc_core_id not found: " + std::to_string(hwloc_core_id));
+    }
+
+    return core_id_to_pu_os_id[hwloc_core_id];
+}
+
+int hardware_hwloc_l3_id_get_by_core_id(const common_t *common, int hwloc_core_id)
+{
+    const std::vector<int> &core_id_to_l3_id = common->topology_tables.core_id_to_l3_id;
+
+    if (hwloc_core_id < 0 || (size_t) hwloc_core_id >= core_id_to_l3_id.size())
+    {
+        XBT_ERROR("hwloc_core_id not found: %d ", hwloc_core_id);
+        throw std::runtime_error("hwloc_core_id not found: " + std::to_string(hwloc_core_id));
+    }
+
+    return core_id_to_l3_id[hwloc_core_id];
+}
+
+const std::vector<int> &hardware_hwloc_core_ids_get_by_numa_id(const common_t *common, int hwloc_numa_id)
+{
+    const std::vector<std::vector<int>> &numa_id_to_core_ids = common->topology_tables.numa_id_to_core_ids;
+
+    if (hwloc_numa_id < 0 || (size_t) hwloc_numa_id >= numa_id_to_core_ids.size())
+    {
+        XBT_ERROR("hwloc_numa_id not found: %d ", hwloc_numa_id);
+        throw std::runtime_error("hwloc_numa_id not found: " + std::to_string(hwloc_numa_id));
+    }
+
+    return numa_id_to_core_ids[hwloc_numa_id];
 }
 
 double hardware_hwloc_core_id_get_clock_frequency(const common_t *common, int hwloc_core_id)
@@ -43,22 +143,22 @@ double hardware_hwloc_core_id_get_clock_frequency(const common_t *common, int hw
 
 double hardware_hwloc_core_id_get_dynamic_clock_frequency(const common_t *common, int hwloc_core_id)
 {
-    hwloc_obj_t core_obj = hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_CORE, hwloc_core_id);
+    const clock_frequency_sampler_t &sampler = common->clock_frequency_sampler;
 
-    // Iterate over the PUs (logical processing units) inside the core to get the OS index
-    int os_core_id = -1;
-    for (unsigned i = 0; i < core_obj->arity; ++i)
-    {
-        hwloc_obj_t pu_obj = core_obj->children[i];
-        if (pu_obj->type == HWLOC_OBJ_PU)
-        {
-            os_core_id = pu_obj->os_index;
-            break;
-        }
-    }
+    // Cached value refreshed by the sampler thread.
+    if (sampler.running.load(std::memory_order_acquire))
+        return sampler.core_id_to_clock_frequency_hz[hwloc_core_id].load(std::memory_order_relaxed);
+
+    return hardware_sysfs_core_id_read_clock_frequency(common, hwloc_core_id);
+}
+
+double hardware_sysfs_core_id_read_clock_frequency(const common_t *common, int hwloc_core_id)
+{
+    // OS index of the first PU of the core.
+    int os_core_id = hardware_hwloc_pu_id_get_by_core_id(common, hwloc_core_id);
 
     // Path to the current frequency file for the given os core id.
-    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(os_core_id) + "/cpufreq/scaling_cur_freq";
+    std::string path = common->clock_frequency_sampler.sysfs_root + "/cpu" + std::to_string(os_core_id) + "/cpufreq/scaling_cur_freq";
     std::ifstream freq_file(path);
 
     if (!freq_file.is_open())
@@ -75,32 +175,426 @@ double hardware_hwloc_core_id_get_dynamic_clock_frequency(const common_t *common
     return frequency_khz * 1000;
 }
 
-int hardware_hwloc_numa_id_get_by_core_id(const common_t *common, int hwloc_core_id)
+static void hardware_clock_frequency_sampler_sample(common_t *common, bool initial)
+{
+    clock_frequency_sampler_t &sampler = common->clock_frequency_sampler;
+
+    for (int core_id : common_core_id_get_avail(common))
+    {
+        double sample_hz = hardware_sysfs_core_id_read_clock_frequency(common, core_id);
+        double previous_hz = sampler.core_id_to_clock_frequency_hz[core_id].load(std::memory_order_relaxed);
+
+        // EWMA: f = alpha * sample + (1 - alpha) * f.
+        double clock_frequency_hz = initial ? sample_hz : sampler.ewma_alpha * sample_hz + (1.0 - sampler.ewma_alpha) * previous_hz;
+        sampler.core_id_to_clock_frequency_hz[core_id].store(clock_frequency_hz, std::memory_order_relaxed);
+    }
+}
+
+static void *hardware_clock_frequency_sampler_thread_function(void *arg)
+{
+    common_t *common = (common_t *) arg;
+    clock_frequency_sampler_t &sampler = common->clock_frequency_sampler;
+
+    pthread_mutex_lock(&(sampler.mutex));
+    while (sampler.running.load(std::memory_order_acquire))
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += sampler.interval_ms / 1000;
+        deadline.tv_nsec += (long) (sampler.interval_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) { deadline.tv_sec += 1; deadline.tv_nsec -= 1000000000; }
+
+        // Wait for the next period (or for hardware_clock_frequency_sampler_stop).
+        if (pthread_cond_timedwait(&(sampler.cond), &(sampler.mutex), &deadline) != ETIMEDOUT) continue;
+
+        pthread_mutex_unlock(&(sampler.mutex));
+
+        try {
+            hardware_clock_frequency_sampler_sample(common, false);
+        } catch (const std::exception &) {
+            // Keep the last values; the error was already logged.
+        }
+
+        pthread_mutex_lock(&(sampler.mutex));
+    }
+    pthread_mutex_unlock(&(sampler.mutex));
+
+    return NULL;
+}
+
+/**
+ * @brief Start the clock frequency sampler thread.
+ *
+ * Only available cores are sampled. The first sample is taken synchronously, so cached
+ * values are valid as soon as this returns.
+ * An interval of 0 disables the sampler (frequencies are read from sysfs on every query).
+ */
+void hardware_clock_frequency_sampler_start(common_t *common)
 {
-    hwloc_obj_t core_obj;
-    hwloc_cpuset_t cpuset;
+    clock_frequency_sampler_t &sampler = common->clock_frequency_sampler;
+
+    if (sampler.interval_ms == 0) return;
 
-    // Traverse through the topology to find the core object with the given core_id
-    core_obj = hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_CORE, hwloc_core_id);
+    sampler.core_id_to_clock_frequency_hz = std::vector<std::atomic<double>>(common->topology_tables.core_id_to_pu_os_id.size());
+    hardware_clock_frequency_sampler_sample(common, true);
 
-    if (core_obj == nullptr)
+    sampler.mutex = PTHREAD_MUTEX_INITIALIZER;
+    sampler.cond = PTHREAD_COND_INITIALIZER;
+    sampler.running.store(true, std::memory_order_release);
+
+    if (pthread_create(&(sampler.thread), NULL, hardware_clock_frequency_sampler_thread_function, common) != 0)
     {
-        XBT_ERROR("hwloc_core_id not found: %d ", hwloc_core_id);
-        throw std::runtime_error("hwloc_core_id not found: " + std::to_string(hwloc_core_id));
+        sampler.running.store(false, std::memory_order_release);
+        XBT_ERROR("unable to create the clock frequency sampler thread.");
+        throw std::runtime_error("unable to create the clock frequency sampler thread.");
     }
 
-    // Get the CPU set (cpuset) of the core
-    cpuset = hwloc_bitmap_dup(core_obj->cpuset);
+    XBT_DEBUG("clock_frequency_sampler: started, interval_ms: %u, ewma_alpha: %f, sysfs_root: %s",
+        sampler.interval_ms, sampler.ewma_alpha, sampler.sysfs_root.c_str());
+}
 
-    // Use hwloc_get_next_obj_covering_cpuset_by_type to find the NUMA node
-    hwloc_obj_t numa_node = NULL;
-    int hwloc_numa_id = -1;
-    while ((numa_node = hwloc_get_next_obj_covering_cpuset_by_type(common->topology, cpuset, HWLOC_OBJ_NUMANODE, numa_node)) != NULL)
-        if (hwloc_bitmap_isincluded(cpuset, numa_node->cpuset))
-            hwloc_numa_id = numa_node->logical_index;
+void hardware_clock_frequency_sampler_stop(common_t *common)
+{
+    clock_frequency_sampler_t &sampler = common->clock_frequency_sampler;
 
-    // Cleanup
-    hwloc_bitmap_free(cpuset);
+    if (!sampler.running.load(std::memory_order_acquire)) return;
+
+    pthread_mutex_lock(&(sampler.mutex));
+    sampler.running.store(false, std::memory_order_release);
+    pthread_cond_signal(&(sampler.cond));
+    pthread_mutex_unlock(&(sampler.mutex));
+
+    pthread_join(sampler.thread, NULL);
+
+    XBT_DEBUG("clock_frequency_sampler: stopped");
+}
+
+// Create a thread pinned to the PU of core_id (calibration and probe threads; the caller joins it).
+static void hardware_thread_create_on_core_id(common_t *common, int core_id, void *(*thread_function)(void *), void *arg, pthread_t *thread)
+{
+    pthread_attr_t attr;
+    cpu_set_t cpuset;
+
+    pthread_attr_init(&attr);
+    CPU_ZERO(&cpuset);
+    CPU_SET(hardware_hwloc_pu_id_get_by_core_id(common, core_id), &cpuset);
+
+    if (pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset) != 0 ||
+        pthread_create(thread, &attr, thread_function, arg) != 0)
+    {
+        pthread_attr_destroy(&attr);
+        XBT_ERROR("unable to create a thread on core_id: %d.", core_id);
+        throw std::runtime_error("unable to create a thread on core_id: " + std::to_string(core_id));
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+struct hardware_calibration_s
+{
+    common_t *common;
+    int core_id;
+    double flops_per_second;
+};
+typedef struct hardware_calibration_s hardware_calibration_t;
+
+static void *hardware_flops_per_cycle_calibrate_thread_function(void *arg)
+{
+    hardware_calibration_t *calibration = (hardware_calibration_t *) arg;
+    common_t *common = calibration->common;
+
+    const double chunk_flops = 1e7;
+    const double duration_us = common->flops_per_cycle_calibration_ms * 1000.0;
+
+    try
+    {
+        kernels_compute_t compute;
+        kernels_compute_initialize(compute, common->mapper_kernels_isa, common->mapper_compute_pattern_type, chunk_flops);
+
+        // Warm-up (caches, TLB and clock ramp-up).
+        kernels_compute(compute, chunk_flops);
+
+        double flops = 0.0;
+        double start_timestamp_us = common_get_time_us();
+        double elapsed_us = 0.0;
+
+        do
+        {
+            kernels_compute(compute, chunk_flops);
+            flops += chunk_flops;
+            elapsed_us = common_get_time_us() - start_timestamp_us;
+        } while (elapsed_us < duration_us);
+
+        kernels_compute_finalize(compute);
+
+        calibration->flops_per_second = flops / (elapsed_us / 1000000);
+    }
+    catch (const std::exception &)
+    {
+        calibration->flops_per_second = 0.0;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Measure the achieved flops per cycle of every available core.
+ *
+ * Runs the configured compute kernel (mapper_compute_pattern_type) for flops_per_cycle_calibration_ms
+ * on each core in turn, one pinned thread at a time, and divides the achieved flops per second by
+ * the core clock frequency. Results are stored in core_id_to_flops_per_cycle, which common_compute_time
+ * uses instead of the user-defined flops_per_cycle, so simulated and bare-metal compute times line up.
+ */
+void hardware_flops_per_cycle_calibrate(common_t *common)
+{
+    if (common->flops_per_cycle_calibration_ms == 0) return;
+
+    std::vector<double> core_id_to_flops_per_cycle(common->core_avail.size(), common->flops_per_cycle);
+
+    for (int core_id : common_core_id_get_avail(common))
+    {
+        hardware_calibration_t calibration = {common, core_id, 0.0};
+
+        pthread_t thread;
+        hardware_thread_create_on_core_id(common, core_id, hardware_flops_per_cycle_calibrate_thread_function, &calibration, &thread);
+        pthread_join(thread, NULL);
+
+        double clock_frequency_hz = hardware_hwloc_core_id_get_clock_frequency(common, core_id);
+
+        if (!(calibration.flops_per_second > 0.0 && clock_frequency_hz > 0.0))
+        {
+            XBT_ERROR("flops_per_cycle calibration failed for core_id: %d.", core_id);
+            throw std::runtime_error("flops_per_cycle calibration failed for core_id: " + std::to_string(core_id));
+        }
+
+        core_id_to_flops_per_cycle[core_id] = calibration.flops_per_second / clock_frequency_hz;
+
+        XBT_INFO("core_id: %d, kernel: %s (%s), flops_per_second: %e, clock_frequency_hz: %e, flops_per_cycle: %f",
+            core_id, kernels_compute_pattern_type_to_str(common->mapper_compute_pattern_type).c_str(),
+            kernels_isa_type_to_str(common->mapper_kernels_isa).c_str(),
+            calibration.flops_per_second, clock_frequency_hz, core_id_to_flops_per_cycle[core_id]);
+    }
+
+    common->core_id_to_flops_per_cycle = core_id_to_flops_per_cycle;
+}
+
+struct hardware_numa_probe_s
+{
+    common_t *common;
+    char *buffer;
+    size_t size;
+    pthread_barrier_t *barrier;
+    double start_us;
+    double end_us;
+    double result;
+};
+typedef struct hardware_numa_probe_s hardware_numa_probe_t;
+
+// Dependent loads over a random cyclic permutation of the cache lines of the buffer
+// (one cache line per load, no prefetching possible); result: ns per load.
+static void *hardware_numa_latency_thread_function(void *arg)
+{
+    hardware_numa_probe_t *probe = (hardware_numa_probe_t *) arg;
+
+    const size_t line_bytes = 64;
+    size_t lines = probe->size / line_bytes;
+
+    // Sattolo's shuffle: a single cycle through every line.
+    std::vector<size_t> order(lines);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 rng(lines);
+    for (size_t i = lines - 1; i > 0; --i)
+        std::swap(order[i], order[std::uniform_int_distribution<size_t>(0, i - 1)(rng)]);
+
+    for (size_t i = 0; i < lines; ++i)
+        *(void **) (probe->buffer + order[i] * line_bytes) = probe->buffer + order[(i + 1) % lines] * line_bytes;
+
+    void **p = (void **) probe->buffer;
+
+    // Warm-up (TLB and page table walks of the first pass).
+    for (size_t i = 0; i < lines; ++i)
+        p = (void **) *p;
+
+    probe->start_us = common_get_monotonic_time_us();
+    for (size_t i = 0; i < lines; ++i)
+        p = (void **) *p;
+    probe->end_us = common_get_monotonic_time_us();
+
+    // Keep the chase alive.
+    void *volatile sink = p;
+    (void) sink;
+
+    probe->result = (probe->end_us - probe->start_us) * 1000.0 / lines;
+
+    return NULL;
+}
+
+// Sequential read of this thread's slice of the buffer; threads start together at the barrier.
+static void *hardware_numa_bandwidth_thread_function(void *arg)
+{
+    hardware_numa_probe_t *probe = (hardware_numa_probe_t *) arg;
+
+    const int passes = 4;
+    const uint64_t *words = (const uint64_t *) probe->buffer;
+    size_t count = probe->size / sizeof(uint64_t);
+
+    uint64_t sum[4] = {0, 0, 0, 0};
+
+    // Warm-up pass.
+    for (size_t i = 0; i + 4 <= count; i += 4)
+        sum[0] += words[i];
+
+    pthread_barrier_wait(probe->barrier);
+    probe->start_us = common_get_monotonic_time_us();
+
+    for (int pass = 0; pass < passes; ++pass)
+        for (size_t i = 0; i + 4 <= count; i += 4)
+        {
+            sum[0] += words[i];
+            sum[1] += words[i + 1];
+            sum[2] += words[i + 2];
+            sum[3] += words[i + 3];
+        }
+
+    probe->end_us = common_get_monotonic_time_us();
+
+    // Keep the reads alive.
+    volatile uint64_t sink = sum[0] + sum[1] + sum[2] + sum[3];
+    (void) sink;
+
+    probe->result = (double) passes * (count - count % 4) * sizeof(uint64_t);
+
+    return NULL;
+}
+
+/**
+ * @brief Measure the NUMA latency and bandwidth matrices (nflows --calibrate).
+ *
+ * For every pair (data numa_id, reader numa_id), a buffer of buffer_bytes is bound to the data NUMA node and:
+ * - latency_ns: one thread pinned to the first core of the reader NUMA node chases pointers through the buffer;
+ * - bandwidth_gbps: one thread per core of the reader NUMA node reads its slice of the buffer; the bandwidth
+ *   is the total bytes read over the time between the first start and the last end.
+ * Rows are indexed by the NUMA node holding the data and columns by the NUMA node of the reader, as in
+ * common_communication_time.
+ */
+void hardware_numa_distances_calibrate(common_t *common, size_t buffer_bytes, distance_matrix_t &lat_ns, distance_matrix_t &bw_gbps)
+{
+    const std::vector<std::vector<int>> &numa_id_to_core_ids = common->topology_tables.numa_id_to_core_ids;
+    size_t numa_count = numa_id_to_core_ids.size();
+
+    lat_ns.assign(numa_count, std::vector<double>(numa_count, 0.0));
+    bw_gbps.assign(numa_count, std::vector<double>(numa_count, 0.0));
+
+    for (size_t data_numa_id = 0; data_numa_id < numa_count; ++data_numa_id)
+    {
+        char *buffer = (char *) hardware_hwloc_alloc_on_numa_id(common, buffer_bytes, data_numa_id);
+
+        for (size_t reader_numa_id = 0; reader_numa_id < numa_count; ++reader_numa_id)
+        {
+            const std::vector<int> &core_ids = numa_id_to_core_ids[reader_numa_id];
+
+            // NUMA nodes without cores (e.g., memory expanders) are only measured as data nodes.
+            if (core_ids.empty())
+            {
+                XBT_WARN("numa_id: %zu has no cores, reads from it are not measured.", reader_numa_id);
+                continue;
+            }
+
+            pthread_t thread;
+            hardware_numa_probe_t latency_probe = {common, buffer, buffer_bytes, nullptr, 0.0, 0.0, 0.0};
+            hardware_thread_create_on_core_id(common, core_ids[0], hardware_numa_latency_thread_function, &latency_probe, &thread);
+            pthread_join(thread, NULL);
+
+            pthread_barrier_t barrier;
+            pthread_barrier_init(&barrier, NULL, core_ids.size());
+
+            size_t slice_bytes = (buffer_bytes / core_ids.size()) & ~((size_t) 63);
+            std::vector<hardware_numa_probe_t> probes(core_ids.size());
+            std::vector<pthread_t> threads(core_ids.size());
+
+            for (size_t i = 0; i < core_ids.size(); ++i)
+            {
+                probes[i] = {common, buffer + i * slice_bytes, slice_bytes, &barrier, 0.0, 0.0, 0.0};
+                hardware_thread_create_on_core_id(common, core_ids[i], hardware_numa_bandwidth_thread_function, &probes[i], &threads[i]);
+            }
+
+            double start_us = INFINITY, end_us = 0.0, bytes = 0.0;
+            for (size_t i = 0; i < core_ids.size(); ++i)
+            {
+                pthread_join(threads[i], NULL);
+                start_us = std::min(start_us, probes[i].start_us);
+                end_us = std::max(end_us, probes[i].end_us);
+                bytes += probes[i].result;
+            }
+
+            pthread_barrier_destroy(&barrier);
+
+            lat_ns[data_numa_id][reader_numa_id] = latency_probe.result;
+            bw_gbps[data_numa_id][reader_numa_id] = bytes / (end_us - start_us) / 1000.0;  // B/us to GB/s
+
+            XBT_INFO("data numa_id: %zu, reader numa_id: %zu (%zu cores), latency_ns: %f, bandwidth_gbps: %f",
+                data_numa_id, reader_numa_id, core_ids.size(), lat_ns[data_numa_id][reader_numa_id], bw_gbps[data_numa_id][reader_numa_id]);
+        }
+
+        hwloc_free(common->topology, buffer, buffer_bytes);
+    }
+}
+
+/**
+ * @brief Distance matrices from the hwloc NUMA latency distances (ACPI SLIT).
+ *
+ * SLIT values are relative (10 for local accesses), so the matrices are scaled from the given local
+ * latency and bandwidth: latency grows and bandwidth shrinks with the SLIT ratio to the local distance.
+ * With a single NUMA node, the local values are used. Returns false if hwloc reports no distances.
+ */
+bool hardware_hwloc_distance_matrices_from_slit(const common_t *common, double local_latency_ns, double local_bandwidth_gbps,
+    distance_matrix_t &lat_ns, distance_matrix_t &bw_gbps)
+{
+    int numa_count = hwloc_get_nbobjs_by_type(common->topology, HWLOC_OBJ_NUMANODE);
+
+    lat_ns.assign(numa_count, std::vector<double>(numa_count, local_latency_ns));
+    bw_gbps.assign(numa_count, std::vector<double>(numa_count, local_bandwidth_gbps));
+
+    if (numa_count <= 1) return true;
+
+    unsigned int nr = 1;
+    struct hwloc_distances_s *distances = nullptr;
+
+    if (hwloc_distances_get_by_name(common->topology, "NUMALatency", &nr, &distances, 0) != 0 || nr == 0)
+        return false;
+
+    for (unsigned int i = 0; i < distances->nbobjs; ++i)
+    {
+        for (unsigned int j = 0; j < distances->nbobjs; ++j)
+        {
+            double local = (double) distances->values[i * distances->nbobjs + i];
+            double ratio = (double) distances->values[i * distances->nbobjs + j] / local;
+
+            // Matrix rows hold the data NUMA node; SLIT rows hold the initiator.
+            int data_numa_id = distances->objs[j]->logical_index;
+            int reader_numa_id = distances->objs[i]->logical_index;
+
+            lat_ns[data_numa_id][reader_numa_id] = local_latency_ns * ratio;
+            bw_gbps[data_numa_id][reader_numa_id] = local_bandwidth_gbps / ratio;
+        }
+    }
+
+    hwloc_distances_release(common->topology, distances);
+
+    return true;
+}
+
+int hardware_hwloc_numa_id_get_by_core_id(const common_t *common, int hwloc_core_id)
+{
+    const std::vector<int> &core_id_to_numa_id = common->topology_tables.core_id_to_numa_id;
+
+    if (hwloc_core_id < 0 || (size_t) hwloc_core_id >= core_id_to_numa_id.size())
+    {
+        XBT_ERROR("hwloc_core_id not found: %d ", hwloc_core_id);
+        throw std::runtime_error("hwloc_core_id not found: " + std::to_string(hwloc_core_id));
+    }
+
+    int hwloc_numa_id = core_id_to_numa_id[hwloc_core_id];
 
     if (hwloc_numa_id == -1)
     {
@@ -216,36 +710,24 @@ hwloc_membind_policy_t hardware_hwloc_thread_mem_policy_get_from_os(const common
 
 thread_locality_t hardware_hwloc_thread_get_locality_from_os(const common_t *common)
 {
-    // Get the current thread's CPU binding
+    // Get the PU on which the current thread last ran
     hwloc_bitmap_t cpuset = hwloc_bitmap_alloc();
     hwloc_get_last_cpu_location(common->topology, cpuset, HWLOC_CPUBIND_THREAD);
 
-    // Get the NUMA node on which the current thread is running
-    hwloc_bitmap_t nodeset = hwloc_bitmap_alloc();
-    hwloc_cpuset_to_nodeset(common->topology, cpuset, nodeset);
-
-    int numa_id = hwloc_bitmap_first(nodeset); // Get the first NUMA node
-
-    // Get the core object corresponding to the CPU binding
-    hwloc_obj_t obj = hwloc_get_obj_covering_cpuset(common->topology, cpuset);
+    int pu_os_id = hwloc_bitmap_first(cpuset);
 
     // Cleanup
     hwloc_bitmap_free(cpuset);
-    hwloc_bitmap_free(nodeset);
-
-    // Traverse up the object hierarchy to find the core object
-    while (obj && obj->type != HWLOC_OBJ_CORE) obj = obj->parent;
 
-    if (!obj)
-    {
-        XBT_ERROR("failed to get core object.");
-        throw std::runtime_error("failed to get core object.");
-    }
+    // Get the core and NUMA node from the topology tables
+    int core_id = hardware_hwloc_core_id_get_by_pu_id(common, pu_os_id);
+    int numa_id = hardware_hwloc_numa_id_get_by_core_id(common, core_id);
 
-    int core_id = obj->logical_index; // Get the logical core ID
+    // Retrieve core migration information of the calling thread (/proc/self/sched is the main thread).
+    std::ifstream sched_file("/proc/thread-self/sched");
 
-    // Retrieve core migration information from /proc/self/sched
-    std::ifstream sched_file("/proc/self/sched");
+    if (!sched_file.is_open())
+        sched_file.open("/proc/self/sched");
 
     if (!sched_file.is_open()) {
         XBT_ERROR("failed to open /proc/self/sched: %s", strerror(errno));
@@ -274,6 +756,16 @@ thread_locality_t hardware_hwloc_thread_get_locality_from_os(const common_t *com
     return {numa_id, core_id, usage.ru_nvcsw, usage.ru_nivcsw, core_migrations};
 }
 
+// Thread-per-task entry point: data is malloc'd by the mapper and owned by the thread.
+static void *hardware_thread_function_run_and_free(void *arg)
+{
+    thread_data_t *data = (thread_data_t *) arg;
+    data->thread_function(data);
+    free(data);
+
+    return NULL;
+}
+
 void hardware_hwloc_thread_bind_to_core_id(thread_data_t *data)
 {
     int pu;
@@ -282,36 +774,15 @@ void hardware_hwloc_thread_bind_to_core_id(thread_data_t *data)
 
     cpu_set_t cpuset;
 
-    hwloc_obj_t core;
-    hwloc_cpuset_t hwloc_cpuset;
-
     // Initialize thread attributes.
     pthread_attr_init(&attr);
 
-    // Retrieve the core object based on the core index.
-    core = hwloc_get_obj_by_type(data->common->topology, HWLOC_OBJ_CORE, data->assigned_core_id);
-    if (!core)
-    {
-        XBT_ERROR("assigned_core_id not found in topology: %d", data->assigned_core_id);
-        throw std::runtime_error("assigned_core_id not found in topology: " + std::to_string(data->assigned_core_id));
-    }
-
-    // Get the cpuset of the core (includes all PUs associated with the core)
-    hwloc_cpuset = hwloc_bitmap_dup(core->cpuset);
-
-    // Remove hyperthreads (keep only the first PU in each core)
-    hwloc_bitmap_singlify(hwloc_cpuset);
+    // First PU of the core (hyperthreads are not used).
+    pu = hardware_hwloc_pu_id_get_by_core_id(data->common, data->assigned_core_id);
 
     // Clear the CPU set
     CPU_ZERO(&cpuset);
-
-    // Convert hwloc cpuset to Linux cpu_set_t using glibc function
-    // Manually iterate over the cpuset and set the corresponding bits in the Linux CPU set
-    for (pu = hwloc_bitmap_first(hwloc_cpuset); pu != -1; pu = hwloc_bitmap_next(hwloc_cpuset, pu))
-        CPU_SET(pu, &cpuset); // Set the corresponding processing unit in the CPU set
-
-    // Free the hwloc cpuset object as it's no longer needed
-    hwloc_bitmap_free(hwloc_cpuset);
+    CPU_SET(pu, &cpuset);
 
     // Set thread affinity
     if (pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset) != 0)
@@ -323,14 +794,15 @@ void hardware_hwloc_thread_bind_to_core_id(thread_data_t *data)
     // Mark the selected hwloc_core_id as unavailable (the thread will release it upon completion).
     common_core_id_set_avail(data->common, data->assigned_core_id, false);
 
-    if (pthread_create(&thread, &attr, data->thread_function, data) != 0)
+    // Counted before the thread starts, so its decrement (completion event) can never come first.
+    common_threads_active_increment(data->common);
+
+    if (pthread_create(&thread, &attr, hardware_thread_function_run_and_free, data) != 0)
     {
         XBT_ERROR("unable to create thread for assigned_core_id: %d", data->assigned_core_id);
         throw std::runtime_error("unable to create thread for assigned_core_id: " + data->assigned_core_id);
     }
 
-    common_threads_active_increment(data->common);
-
     pthread_attr_destroy(&attr);
 
     pthread_detach(thread);
@@ -338,3 +810,769 @@ void hardware_hwloc_thread_bind_to_core_id(thread_data_t *data)
     // Clean up
     // thread_data is freed in thread_function.
 }
+
+static void *hardware_worker_thread_function(void *arg)
+{
+    hardware_worker_t *worker = (hardware_worker_t *) arg;
+
+    pthread_mutex_lock(&(worker->mutex));
+    while (true)
+    {
+        while (!worker->pending && !worker->stop)
+            pthread_cond_wait(&(worker->cond), &(worker->mutex));
+
+        if (!worker->pending) break; // stop requested and mailbox empty.
+
+        worker->data->exec_id = worker->pending_exec_id;
+        worker->data->exec = worker->pending_exec;
+        worker->pending = false;
+
+        pthread_mutex_unlock(&(worker->mutex));
+        worker->data->thread_function(worker->data);
+        pthread_mutex_lock(&(worker->mutex));
+    }
+    pthread_mutex_unlock(&(worker->mutex));
+
+    return NULL;
+}
+
+static void *hardware_hwloc_alloc_on_numa_id(const common_t *common, size_t size, int numa_id)
+{
+    hwloc_obj_t numa_obj = hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_NUMANODE, numa_id);
+    void *ptr = hwloc_alloc_membind(common->topology, size, numa_obj->nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_BYNODESET);
+
+    if (!ptr)
+    {
+        XBT_ERROR("unable to allocate %zu bytes on numa_id: %d", size, numa_id);
+        throw std::runtime_error("unable to allocate memory on numa_id: " + std::to_string(numa_id));
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief Start one worker per available core.
+ *
+ * Each worker is pinned once to the first PU of its core; its stack, thread data and
+ * mailbox are bound to the NUMA node of the core.
+ */
+void hardware_worker_pool_start(common_t *common, hardware_worker_pool_t &pool, mapper_thread_function_t thread_function)
+{
+    pool.assign(common->core_avail.size(), nullptr);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    size_t stack_size;
+    pthread_attr_getstacksize(&attr, &stack_size);
+
+    for (int core_id : common_core_id_get_avail(common))
+    {
+        int numa_id = hardware_hwloc_numa_id_get_by_core_id(common, core_id);
+
+        hardware_worker_t *worker = (hardware_worker_t *) hardware_hwloc_alloc_on_numa_id(common, sizeof(hardware_worker_t), numa_id);
+        memset(worker, 0, sizeof(hardware_worker_t));
+
+        worker->common = common;
+        worker->mutex = PTHREAD_MUTEX_INITIALIZER;
+        worker->cond = PTHREAD_COND_INITIALIZER;
+
+        worker->data = (thread_data_t *) hardware_hwloc_alloc_on_numa_id(common, sizeof(thread_data_t), numa_id);
+        memset(worker->data, 0, sizeof(thread_data_t));
+        worker->data->assigned_core_id = core_id;
+        worker->data->common = common;
+        worker->data->thread_function = thread_function;
+
+        worker->stack_size = stack_size;
+        worker->stack = hardware_hwloc_alloc_on_numa_id(common, stack_size, numa_id);
+
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(hardware_hwloc_pu_id_get_by_core_id(common, core_id), &cpuset);
+
+        pthread_attr_t worker_attr;
+        pthread_attr_init(&worker_attr);
+        pthread_attr_setstack(&worker_attr, worker->stack, worker->stack_size);
+
+        const char *error = nullptr;
+        if (pthread_attr_setaffinity_np(&worker_attr, sizeof(cpu_set_t), &cpuset) != 0)
+            error = "set thread affinity failed";
+        else if (pthread_create(&(worker->thread), &worker_attr, hardware_worker_thread_function, worker) != 0)
+            error = "unable to create worker thread";
+
+        pthread_attr_destroy(&worker_attr);
+
+        if (error)
+        {
+            // This worker has no thread; the workers already created are stopped and joined.
+            hwloc_free(common->topology, worker->stack, worker->stack_size);
+            hwloc_free(common->topology, worker->data, sizeof(thread_data_t));
+            hwloc_free(common->topology, worker, sizeof(hardware_worker_t));
+            pthread_attr_destroy(&attr);
+            hardware_worker_pool_stop(pool);
+
+            XBT_ERROR("%s for core_id: %d.", error, core_id);
+            throw std::runtime_error(std::string(error) + " for core_id: " + std::to_string(core_id));
+        }
+
+        pool[core_id] = worker;
+
+        XBT_DEBUG("worker_pool: core_id: %d, numa_id: %d, stack_size: %zu", core_id, numa_id, stack_size);
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+/**
+ * @brief Hand an exec to the worker of core_id (replaces a thread creation per task).
+ */
+void hardware_worker_pool_submit(hardware_worker_pool_t &pool, int core_id, unsigned int exec_id, simgrid_exec_t *exec)
+{
+    hardware_worker_t *worker = pool.at(core_id);
+
+    if (!worker)
+    {
+        XBT_ERROR("no worker for core_id: %d", core_id);
+        throw std::runtime_error("no worker for core_id: " + std::to_string(core_id));
+    }
+
+    // Mark the core as unavailable (the worker will release it upon completion).
+    common_core_id_set_avail(worker->common, core_id, false);
+    common_threads_active_increment(worker->common);
+
+    pthread_mutex_lock(&(worker->mutex));
+    worker->pending_exec_id = exec_id;
+    worker->pending_exec = exec;
+    worker->pending = true;
+    pthread_cond_signal(&(worker->cond));
+    pthread_mutex_unlock(&(worker->mutex));
+}
+
+/**
+ * @brief Stop the workers once their mailboxes are empty, and release their memory.
+ */
+void hardware_worker_pool_stop(hardware_worker_pool_t &pool)
+{
+    for (hardware_worker_t *worker : pool)
+    {
+        if (!worker) continue;
+
+        pthread_mutex_lock(&(worker->mutex));
+        worker->stop = true;
+        pthread_cond_signal(&(worker->cond));
+        pthread_mutex_unlock(&(worker->mutex));
+
+        pthread_join(worker->thread, NULL);
+
+        hwloc_topology_t topology = worker->common->topology;
+        hwloc_free(topology, worker->stack, worker->stack_size);
+        hwloc_free(topology, worker->data, sizeof(thread_data_t));
+        hwloc_free(topology, worker, sizeof(hardware_worker_t));
+    }
+
+    pool.clear();
+}
+
+#define HARDWARE_PAGE_BYTES ((size_t) 4096)
+#define HARDWARE_HUGE_PAGE_BYTES ((size_t) 2 * 1024 * 1024)
+
+/**
+ * @brief Prepare one (empty) arena per NUMA node. Blocks are only allocated on demand.
+ */
+void hardware_numa_arena_initialize(common_t *common)
+{
+    numa_arena_t &arena = common->mapper_mem_arena;
+
+    int numa_count = hwloc_get_nbobjs_by_type(common->topology, HWLOC_OBJ_NUMANODE);
+
+    arena.numa_id_to_size_class_to_blocks.assign(numa_count, std::vector<std::vector<void *>>());
+    arena.block_to_numa_id_size_class.clear();
+    arena.blocks_allocated = 0;
+    arena.blocks_recycled = 0;
+    arena.huge_pages_unavailable.store(false, std::memory_order_relaxed);
+    arena.mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    if (arena.enabled)
+        XBT_INFO("numa_arena: enabled, numa nodes: %d, huge_pages: %s", numa_count, common_huge_pages_type_to_str(arena.huge_pages_type).c_str());
+}
+
+/**
+ * @brief NUMA node where the data item of comm_id is placed.
+ *
+ * Deterministic: round-robin over mapper_mem_bind_numa_node_ids for the bind policy,
+ * otherwise the NUMA node of the writer core.
+ */
+int hardware_numa_arena_numa_id_get(const common_t *common, unsigned int comm_id, int core_id)
+{
+    const std::vector<unsigned> &numa_ids = common->mapper_mem_bind_numa_node_ids;
+
+    if (common->mapper_mem_policy_type == HWLOC_MEMBIND_BIND && !numa_ids.empty())
+        return numa_ids[comm_id % numa_ids.size()];
+
+    return hardware_hwloc_numa_id_get_by_core_id(common, core_id);
+}
+
+static int hardware_numa_arena_size_class(const numa_arena_t &arena, size_t size)
+{
+    size_t min_block_size = (arena.huge_pages_type == COMMON_HUGE_PAGES_NONE) ? HARDWARE_PAGE_BYTES : HARDWARE_HUGE_PAGE_BYTES;
+    size = std::max(size, min_block_size);
+
+    int size_class = 0;
+    while (((size_t) 1 << size_class) < size) size_class++;
+
+    return size_class;
+}
+
+static void *hardware_numa_arena_block_alloc(common_t *common, size_t block_size, int numa_id)
+{
+    numa_arena_t &arena = common->mapper_mem_arena;
+
+    hwloc_obj_t numa_obj = hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_NUMANODE, numa_id);
+
+    if (!numa_obj)
+    {
+        XBT_ERROR("numa_arena: numa_id %d not found.", numa_id);
+        return nullptr;
+    }
+
+    if (arena.huge_pages_type == COMMON_HUGE_PAGES_EXPLICIT)
+    {
+        // Pages from the hugetlbfs pool (vm.nr_hugepages), then bound to the node.
+        // If the pool is exhausted, regular pages are mapped instead (blocks are always munmap'ed).
+        void *ptr = MAP_FAILED;
+        if (!arena.huge_pages_unavailable.load(std::memory_order_relaxed))
+            ptr = mmap(NULL, block_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (ptr == MAP_FAILED)
+        {
+            if (!arena.huge_pages_unavailable.exchange(true, std::memory_order_relaxed))
+                XBT_WARN("numa_arena: unable to map %zu bytes of explicit huge pages (vm.nr_hugepages), using regular pages.", block_size);
+
+            ptr = mmap(NULL, block_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+
+        if (ptr == MAP_FAILED)
+        {
+            XBT_ERROR("numa_arena: unable to map %zu bytes.", block_size);
+            return nullptr;
+        }
+
+        if (hwloc_set_area_membind(common->topology, ptr, block_size, numa_obj->nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_BYNODESET) != 0)
+        {
+            munmap(ptr, block_size);
+            XBT_ERROR("numa_arena: unable to bind %zu bytes to numa_id: %d.", block_size, numa_id);
+            return nullptr;
+        }
+
+        return ptr;
+    }
+
+    void *ptr = hwloc_alloc_membind(common->topology, block_size, numa_obj->nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_BYNODESET);
+
+    if (ptr && arena.huge_pages_type == COMMON_HUGE_PAGES_TRANSPARENT)
+        madvise(ptr, block_size, MADV_HUGEPAGE);
+
+    return ptr;
+}
+
+static void hardware_numa_arena_block_free(const common_t *common, void *ptr, size_t block_size)
+{
+    if (common->mapper_mem_arena.huge_pages_type == COMMON_HUGE_PAGES_EXPLICIT)
+        munmap(ptr, block_size);
+    else
+        hwloc_free(common->topology, ptr, block_size);
+}
+
+/**
+ * @brief Allocate size bytes on numa_id; a freed block of the same size class is reused if any.
+ *
+ * Falls back to malloc when the arena is disabled.
+ *
+ * @return The block address, or nullptr on failure.
+ */
+char *hardware_numa_arena_alloc(common_t *common, size_t size, int numa_id)
+{
+    numa_arena_t &arena = common->mapper_mem_arena;
+
+    if (!arena.enabled) return (char *) malloc(size);
+
+    int size_class = hardware_numa_arena_size_class(arena, size);
+
+    pthread_mutex_lock(&(arena.mutex));
+
+    std::vector<std::vector<void *>> &size_class_to_blocks = arena.numa_id_to_size_class_to_blocks.at(numa_id);
+    if (size_class_to_blocks.size() <= (size_t) size_class)
+        size_class_to_blocks.resize(size_class + 1);
+
+    std::vector<void *> &blocks = size_class_to_blocks[size_class];
+
+    if (!blocks.empty())
+    {
+        void *ptr = blocks.back();
+        blocks.pop_back();
+        arena.blocks_recycled += 1;
+
+        pthread_mutex_unlock(&(arena.mutex));
+        return (char *) ptr;
+    }
+
+    pthread_mutex_unlock(&(arena.mutex));
+
+    // The system call is done without holding the arena lock.
+    void *ptr = hardware_numa_arena_block_alloc(common, (size_t) 1 << size_class, numa_id);
+    if (!ptr) return nullptr;
+
+    pthread_mutex_lock(&(arena.mutex));
+    arena.block_to_numa_id_size_class[ptr] = {numa_id, size_class};
+    arena.blocks_allocated += 1;
+    pthread_mutex_unlock(&(arena.mutex));
+
+    return (char *) ptr;
+}
+
+/**
+ * @brief Return a block to the free list of its NUMA node and size class (free when the arena is disabled).
+ */
+void hardware_numa_arena_free(common_t *common, char *address)
+{
+    numa_arena_t &arena = common->mapper_mem_arena;
+
+    if (!arena.enabled)
+    {
+        free(address);
+        return;
+    }
+
+    pthread_mutex_lock(&(arena.mutex));
+
+    auto it = arena.block_to_numa_id_size_class.find(address);
+    if (it == arena.block_to_numa_id_size_class.end())
+    {
+        pthread_mutex_unlock(&(arena.mutex));
+        XBT_ERROR("numa_arena: address %p was not allocated by the arena.", (void *) address);
+        throw std::runtime_error("numa_arena: address was not allocated by the arena.");
+    }
+
+    auto [numa_id, size_class] = it->second;
+    arena.numa_id_to_size_class_to_blocks[numa_id][size_class].push_back(address);
+
+    pthread_mutex_unlock(&(arena.mutex));
+}
+
+/**
+ * @brief Release every block (free or still in use) to the OS.
+ */
+void hardware_numa_arena_finalize(common_t *common)
+{
+    numa_arena_t &arena = common->mapper_mem_arena;
+
+    if (!arena.enabled) return;
+
+    XBT_INFO("numa_arena: blocks allocated: %zu, blocks recycled: %zu", arena.blocks_allocated, arena.blocks_recycled);
+
+    for (const auto &[ptr, numa_id_size_class] : arena.block_to_numa_id_size_class)
+        hardware_numa_arena_block_free(common, ptr, (size_t) 1 << numa_id_size_class.second);
+
+    arena.block_to_numa_id_size_class.clear();
+    arena.numa_id_to_size_class_to_blocks.clear();
+}
+
+/**
+ * @brief Move an arena block to the free lists of numa_id once its pages were migrated there.
+ *
+ * @return The block size, or 0 if address was not allocated by the arena.
+ */
+static size_t hardware_numa_arena_block_set_numa_id(common_t *common, void *address, int numa_id)
+{
+    numa_arena_t &arena = common->mapper_mem_arena;
+
+    if (!arena.enabled) return 0;
+
+    pthread_mutex_lock(&(arena.mutex));
+
+    auto it = arena.block_to_numa_id_size_class.find(address);
+    size_t block_size = 0;
+
+    if (it != arena.block_to_numa_id_size_class.end())
+    {
+        it->second.first = numa_id;
+        block_size = (size_t) 1 << it->second.second;
+    }
+
+    pthread_mutex_unlock(&(arena.mutex));
+
+    return block_size;
+}
+
+static void hardware_prefetcher_migrate(common_t *common, unsigned int comm_id, int numa_id)
+{
+    char *address = common_comm_id_to_address_get(common, comm_id);
+    size_t size = (size_t) std::get<2>(common_comm_id_to_w_time_offset_payload_get(common, comm_id));
+
+    // Arena blocks are migrated as a whole, so they can be recycled on their new node.
+    size_t block_size = hardware_numa_arena_block_set_numa_id(common, address, numa_id);
+    if (block_size > 0) size = block_size;
+
+    hwloc_obj_t numa_obj = hwloc_get_obj_by_type(common->topology, HWLOC_OBJ_NUMANODE, numa_id);
+
+    if (!numa_obj || hwloc_set_area_membind(common->topology, address, size, numa_obj->nodeset,
+            HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_MIGRATE | HWLOC_MEMBIND_BYNODESET) != 0)
+    {
+        // The exec reads the data item remotely.
+        XBT_WARN("prefetcher: unable to migrate %s (%zu bytes) to numa_id: %d.",
+            common->workflow.comm_names[comm_id].c_str(), size, numa_id);
+    }
+}
+
+static void *hardware_prefetcher_thread_function(void *arg)
+{
+    common_t *common = (common_t *) arg;
+    prefetcher_t &prefetcher = common->mapper_prefetcher;
+
+    pthread_mutex_lock(&(prefetcher.mutex));
+    while (true)
+    {
+        while (prefetcher.running && prefetcher.queue_head == prefetcher.queue.size())
+            pthread_cond_wait(&(prefetcher.cond), &(prefetcher.mutex));
+
+        // Pending migrations are still carried out on stop, since readers may be waiting for them.
+        if (prefetcher.queue_head == prefetcher.queue.size()) break;
+
+        auto [comm_id, numa_id] = prefetcher.queue[prefetcher.queue_head++];
+
+        pthread_mutex_unlock(&(prefetcher.mutex));
+
+        double migration_start_timestamp_us = common_get_time_us();
+        hardware_prefetcher_migrate(common, comm_id, numa_id);
+        double migration_end_timestamp_us = common_get_time_us();
+
+        pthread_mutex_lock(&(prefetcher.mutex));
+
+        prefetcher.comm_id_to_state[comm_id] = 2;
+        prefetcher.comm_id_to_migration_time_us[comm_id] = migration_end_timestamp_us - migration_start_timestamp_us;
+        prefetcher.migrations += 1;
+        pthread_cond_broadcast(&(prefetcher.cond));
+    }
+    pthread_mutex_unlock(&(prefetcher.mutex));
+
+    return NULL;
+}
+
+/**
+ * @brief Start the input prefetcher thread (mapper_prefetch).
+ *
+ * The thread is not bound to a core, so the scheduler keeps every available core for execs.
+ */
+void hardware_prefetcher_start(common_t *common)
+{
+    prefetcher_t &prefetcher = common->mapper_prefetcher;
+
+    if (!common->mapper_prefetch) return;
+
+    size_t comms_count = common->workflow.comm_names.size();
+
+    prefetcher.queue.clear();
+    prefetcher.queue.reserve(comms_count);
+    prefetcher.queue_head = 0;
+    prefetcher.comm_id_to_state.assign(comms_count, 0);
+    prefetcher.comm_id_to_migration_time_us.assign(comms_count, 0.0);
+    prefetcher.migrations = 0;
+
+    prefetcher.mutex = PTHREAD_MUTEX_INITIALIZER;
+    prefetcher.cond = PTHREAD_COND_INITIALIZER;
+    prefetcher.running = true;
+
+    if (pthread_create(&(prefetcher.thread), NULL, hardware_prefetcher_thread_function, common) != 0)
+    {
+        prefetcher.running = false;
+        XBT_ERROR("unable to create the prefetcher thread.");
+        throw std::runtime_error("unable to create the prefetcher thread.");
+    }
+
+    XBT_DEBUG("prefetcher: started");
+}
+
+/**
+ * @brief Queue the migration of the data item of comm_id to numa_id.
+ */
+void hardware_prefetcher_submit(common_t *common, unsigned int comm_id, int numa_id)
+{
+    prefetcher_t &prefetcher = common->mapper_prefetcher;
+
+    pthread_mutex_lock(&(prefetcher.mutex));
+
+    if (prefetcher.comm_id_to_state[comm_id] == 0)
+    {
+        prefetcher.comm_id_to_state[comm_id] = 1;
+        prefetcher.queue.push_back({comm_id, numa_id});
+        pthread_cond_broadcast(&(prefetcher.cond));
+    }
+
+    pthread_mutex_unlock(&(prefetcher.mutex));
+}
+
+/**
+ * @brief Block until the migration of comm_id (if queued) is done.
+ *
+ * @param migration_time_us Set to the time the prefetcher spent migrating the data item (0 if not queued).
+ * @return The time (us) the caller was blocked.
+ */
+double hardware_prefetcher_wait(common_t *common, unsigned int comm_id, double *migration_time_us)
+{
+    prefetcher_t &prefetcher = common->mapper_prefetcher;
+
+    *migration_time_us = 0.0;
+
+    if (!common->mapper_prefetch) return 0.0;
+
+    double wait_start_timestamp_us = common_get_time_us();
+
+    pthread_mutex_lock(&(prefetcher.mutex));
+
+    while (prefetcher.comm_id_to_state[comm_id] == 1)
+        pthread_cond_wait(&(prefetcher.cond), &(prefetcher.mutex));
+
+    *migration_time_us = prefetcher.comm_id_to_migration_time_us[comm_id];
+
+    pthread_mutex_unlock(&(prefetcher.mutex));
+
+    return (*migration_time_us > 0.0) ? common_get_time_us() - wait_start_timestamp_us : 0.0;
+}
+
+void hardware_prefetcher_stop(common_t *common)
+{
+    prefetcher_t &prefetcher = common->mapper_prefetcher;
+
+    if (!common->mapper_prefetch || !prefetcher.running) return;
+
+    pthread_mutex_lock(&(prefetcher.mutex));
+    prefetcher.running = false;
+    pthread_cond_broadcast(&(prefetcher.cond));
+    pthread_mutex_unlock(&(prefetcher.mutex));
+
+    pthread_join(prefetcher.thread, NULL);
+
+    XBT_INFO("prefetcher: migrations: %zu", prefetcher.migrations);
+}
+
+struct hardware_perf_event_s
+{
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+    bool required;  // The source is unusable if a required event cannot be opened.
+};
+typedef struct hardware_perf_event_s hardware_perf_event_t;
+
+#define HARDWARE_PERF_CACHE_CONFIG(cache, op, result) \
+    ((uint64_t) (cache) | ((uint64_t) (op) << 8) | ((uint64_t) (result) << 16))
+
+// NUMA node accesses: on most PMUs, node-loads count local DRAM reads and node-load-misses remote ones.
+static const std::vector<hardware_perf_event_t> hardware_perf_events_hardware = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true},
+    {"llc_misses", PERF_TYPE_HW_CACHE, HARDWARE_PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), false},
+    {"local_dram_reads", PERF_TYPE_HW_CACHE, HARDWARE_PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS), false},
+    {"remote_dram_reads", PERF_TYPE_HW_CACHE, HARDWARE_PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), false},
+};
+
+static const std::vector<hardware_perf_event_t> hardware_perf_events_software = {
+    {"task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, true},
+    {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, false},
+    {"context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false},
+    {"cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, false},
+};
+
+static const std::vector<std::string> hardware_perf_names_rusage = {"task_clock_ns", "page_faults", "context_switches"};
+
+// Counter group of the calling thread, opened on first use and closed when the thread exits.
+struct hardware_perf_group_s
+{
+    bool opened = false;
+    int group_fd = -1;
+    std::vector<int> fds;  // By counter (perf_counter_names order); -1 if the event could not be opened.
+
+    ~hardware_perf_group_s()
+    {
+        for (int fd : fds)
+            if (fd != -1) close(fd);
+    }
+};
+typedef struct hardware_perf_group_s hardware_perf_group_t;
+
+static thread_local hardware_perf_group_t hardware_perf_group;
+
+static int hardware_perf_event_open(const hardware_perf_event_t &event, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = (group_fd == -1) ? 1 : 0;  // The leader starts the whole group.
+    attr.exclude_kernel = 1;  // Allowed with perf_event_paranoid <= 2.
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // Calling thread, any CPU.
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+/**
+ * @brief Open the events of a source as a single group for the calling thread.
+ *
+ * @return false if a required event could not be opened (errno is kept).
+ */
+static bool hardware_perf_group_open(hardware_perf_group_t &group, const std::vector<hardware_perf_event_t> &events, std::vector<std::string> *names)
+{
+    group.group_fd = -1;
+    group.fds.clear();
+
+    for (const hardware_perf_event_t &event : events)
+    {
+        int fd = hardware_perf_event_open(event, group.group_fd);
+
+        if (fd == -1 && event.required)
+        {
+            int open_errno = errno;
+            for (int opened_fd : group.fds)
+                if (opened_fd != -1) close(opened_fd);
+            group.fds.clear();
+            group.group_fd = -1;
+            errno = open_errno;
+            return false;
+        }
+
+        // While probing, events not exposed by the PMU are dropped from the counter set.
+        if (fd == -1 && names) continue;
+
+        if (group.group_fd == -1) group.group_fd = fd;
+        group.fds.push_back(fd);
+        if (names) names->push_back(event.name);
+    }
+
+    ioctl(group.group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group.group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    return true;
+}
+
+/**
+ * @brief Select the counter source (mapper_perf_counters) by probing perf_event_open on the calling thread.
+ *
+ * Hardware events are tried first, then software events, then getrusage.
+ */
+void hardware_perf_counters_initialize(common_t *common)
+{
+    common->perf_counters_type = COMMON_PERF_COUNTERS_NONE;
+    common->perf_counter_names.clear();
+
+    if (common->mapper_perf_counters)
+    {
+        hardware_perf_group_t probe;
+
+        if (hardware_perf_group_open(probe, hardware_perf_events_hardware, &(common->perf_counter_names)))
+        {
+            common->perf_counters_type = COMMON_PERF_COUNTERS_HARDWARE;
+        } else {
+            XBT_WARN("perf_counters: hardware events unavailable (%s, see /proc/sys/kernel/perf_event_paranoid), trying software events.", strerror(errno));
+
+            if (hardware_perf_group_open(probe, hardware_perf_events_software, &(common->perf_counter_names)))
+            {
+                common->perf_counters_type = COMMON_PERF_COUNTERS_SOFTWARE;
+            } else {
+                XBT_WARN("perf_counters: perf_event_open unavailable (%s), using getrusage.", strerror(errno));
+
+                common->perf_counters_type = COMMON_PERF_COUNTERS_RUSAGE;
+                common->perf_counter_names = hardware_perf_names_rusage;
+            }
+        }
+
+        XBT_INFO("perf_counters: source: %s, counters: [%s]", common_perf_counters_type_to_str(common->perf_counters_type).c_str(),
+            std::accumulate(common->perf_counter_names.begin(), common->perf_counter_names.end(), std::string(),
+                [](const std::string &a, const std::string &b) { return a.empty() ? b : a + "," + b; }).c_str());
+    }
+
+    id_to_perf_counters_t &mapping = common->exec_id_to_perf_counters;
+    size_t execs_count = common->workflow.exec_names.size();
+
+    mapping.counters_count = common->perf_counter_names.size();
+    mapping.values.assign(execs_count * COMMON_PHASES_COUNT * mapping.counters_count, 0.0);
+    mapping.recorded.assign(execs_count, 0);
+}
+
+/**
+ * @brief Current counter totals of the calling thread (perf_counter_names order).
+ *
+ * Values are scaled when the PMU multiplexes the group.
+ */
+void hardware_perf_counters_sample(const common_t *common, std::vector<double> &values)
+{
+    values.assign(common->perf_counter_names.size(), 0.0);
+
+    if (common->perf_counters_type == COMMON_PERF_COUNTERS_RUSAGE)
+    {
+        struct timespec thread_cpu_time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &thread_cpu_time);
+
+        struct rusage usage;
+        getrusage(RUSAGE_THREAD, &usage);
+
+        values[0] = (double) thread_cpu_time.tv_sec * 1e9 + (double) thread_cpu_time.tv_nsec;
+        values[1] = (double) (usage.ru_minflt + usage.ru_majflt);
+        values[2] = (double) (usage.ru_nvcsw + usage.ru_nivcsw);
+        return;
+    }
+
+    hardware_perf_group_t &group = hardware_perf_group;
+
+    if (!group.opened)
+    {
+        group.opened = true;
+
+        const std::vector<hardware_perf_event_t> &all_events = (common->perf_counters_type == COMMON_PERF_COUNTERS_HARDWARE) ?
+            hardware_perf_events_hardware : hardware_perf_events_software;
+
+        // Same counter set as the one probed at runtime_initialize.
+        std::vector<hardware_perf_event_t> events;
+        for (const std::string &name : common->perf_counter_names)
+            for (const hardware_perf_event_t &event : all_events)
+                if (name == event.name) events.push_back(event);
+
+        if (!hardware_perf_group_open(group, events, nullptr))
+            XBT_WARN("perf_counters: unable to open the counters of thread %d (%s).", gettid(), strerror(errno));
+    }
+
+    if (group.group_fd == -1) return;
+
+    // Group read format: nr, time_enabled, time_running, values[nr] (opened members only).
+    std::vector<uint64_t> buffer(3 + group.fds.size(), 0);
+    if (read(group.group_fd, buffer.data(), buffer.size() * sizeof(uint64_t)) <= 0) return;
+
+    double scale = (buffer[2] > 0) ? (double) buffer[1] / (double) buffer[2] : 0.0;
+
+    size_t member = 0;
+    for (size_t i = 0; i < group.fds.size() && member < buffer[0]; ++i)
+        if (group.fds[i] != -1)
+            values[i] = (double) buffer[3 + member++] * scale;
+}
+
+/**
+ * @brief Record the counters of a phase of exec_id: the difference from values, then values is updated.
+ */
+void hardware_perf_counters_record(common_t *common, unsigned int exec_id, phase_type_t phase, std::vector<double> &values)
+{
+    if (common->perf_counters_type == COMMON_PERF_COUNTERS_NONE) return;
+
+    std::vector<double> current_values;
+    hardware_perf_counters_sample(common, current_values);
+
+    std::vector<double> phase_values(current_values.size());
+    for (size_t i = 0; i < current_values.size(); ++i)
+        phase_values[i] = std::max(0.0, current_values[i] - values[i]);
+
+    common_exec_id_to_perf_counters_create(common, exec_id, phase, phase_values);
+
+    values.swap(current_values);
+}
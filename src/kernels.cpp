@@ -0,0 +1,654 @@
+#include "kernels.hpp"
+
+#include <xbt/log.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNELS_X86
+#endif
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(kernels, "Messages specific to this module.");
+
+// Sum of the (unsigned) bytes of a buffer; the read checksum.
+typedef size_t (*kernels_sum_t)(const char *buffer, size_t bytes);
+
+// Zero a buffer with non-temporal stores.
+typedef void (*kernels_stream_t)(char *buffer, size_t bytes);
+
+// Perform (about) flops floating-point operations on registers; returns the accumulators sum.
+typedef double (*kernels_fma_t)(double flops);
+
+// a[i] = b[i] + s * c[i], followed by a number of dependent FMAs (template parameter).
+typedef void (*kernels_triad_t)(double *a, const double *b, const double *c, size_t elements);
+
+struct kernels_ops_s
+{
+    kernels_sum_t sum;
+    kernels_stream_t stream;
+    kernels_fma_t fma;
+    kernels_triad_t triad;
+    kernels_triad_t mixed;
+};
+typedef struct kernels_ops_s kernels_ops_t;
+
+/* SCALAR */
+static size_t kernels_sum_scalar(const char *buffer, size_t bytes)
+{
+    const unsigned char *bytes_ptr = (const unsigned char *) buffer;
+
+    size_t sum = 0;
+    for (size_t i = 0; i < bytes; i++)
+        sum += bytes_ptr[i];
+
+    return sum;
+}
+
+static void kernels_stream_scalar(char *buffer, size_t bytes)
+{
+    memset(buffer, 0, bytes);
+}
+
+// acc = acc * mul + add converges to 1.0, so values never overflow nor become denormal.
+static const double kernels_fma_mul = 0.5;
+static const double kernels_fma_add = 0.5;
+static const double kernels_triad_scalar = 3.0;
+
+static double kernels_fma_scalar(double flops)
+{
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0, acc4 = 0.0, acc5 = 0.0, acc6 = 0.0, acc7 = 0.0;
+
+    // 8 accumulators x 2 flops.
+    size_t iterations = (size_t) (flops / 16);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        acc0 = acc0 * kernels_fma_mul + kernels_fma_add;
+        acc1 = acc1 * kernels_fma_mul + kernels_fma_add;
+        acc2 = acc2 * kernels_fma_mul + kernels_fma_add;
+        acc3 = acc3 * kernels_fma_mul + kernels_fma_add;
+        acc4 = acc4 * kernels_fma_mul + kernels_fma_add;
+        acc5 = acc5 * kernels_fma_mul + kernels_fma_add;
+        acc6 = acc6 * kernels_fma_mul + kernels_fma_add;
+        acc7 = acc7 * kernels_fma_mul + kernels_fma_add;
+    }
+
+    size_t remainder = (size_t) ((flops - iterations * 16.0) / 2);
+    for (size_t i = 0; i < remainder; i++)
+        acc0 = acc0 * kernels_fma_mul + kernels_fma_add;
+
+    return acc0 + acc1 + acc2 + acc3 + acc4 + acc5 + acc6 + acc7;
+}
+
+template <unsigned int fmas>
+static void kernels_triad_scalar_fmas(double *a, const double *b, const double *c, size_t elements)
+{
+    for (size_t i = 0; i < elements; i++)
+    {
+        double x = b[i] + kernels_triad_scalar * c[i];
+        for (unsigned int k = 0; k < fmas; k++)
+            x = x * kernels_fma_mul + kernels_fma_add;
+        a[i] = x;
+    }
+}
+
+#ifdef KERNELS_X86
+/*
+ * Vector kernels. Sums use psadbw against zero (8 bytes -> one 64-bit lane) with four
+ * independent accumulators, so loads are not serialized by the additions.
+ * Streams write the unaligned head and tail with memset and the body with movnt stores.
+ */
+
+/* SSE2 */
+__attribute__((target("sse2")))
+static size_t kernels_sum_sse2(const char *buffer, size_t bytes)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = zero, acc1 = zero, acc2 = zero, acc3 = zero;
+
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64)
+    {
+        acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_loadu_si128((const __m128i *) (buffer + i)), zero));
+        acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(_mm_loadu_si128((const __m128i *) (buffer + i + 16)), zero));
+        acc2 = _mm_add_epi64(acc2, _mm_sad_epu8(_mm_loadu_si128((const __m128i *) (buffer + i + 32)), zero));
+        acc3 = _mm_add_epi64(acc3, _mm_sad_epu8(_mm_loadu_si128((const __m128i *) (buffer + i + 48)), zero));
+    }
+
+    __m128i acc = _mm_add_epi64(_mm_add_epi64(acc0, acc1), _mm_add_epi64(acc2, acc3));
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, acc);
+
+    return lanes[0] + lanes[1] + kernels_sum_scalar(buffer + i, bytes - i);
+}
+
+__attribute__((target("sse2")))
+static void kernels_stream_sse2(char *buffer, size_t bytes)
+{
+    size_t head = std::min(bytes, (size_t) (-(uintptr_t) buffer & 15));
+    memset(buffer, 0, head);
+
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = head;
+    for (; i + 16 <= bytes; i += 16)
+        _mm_stream_si128((__m128i *) (buffer + i), zero);
+
+    memset(buffer + i, 0, bytes - i);
+    _mm_sfence();
+}
+
+// SSE2 has no FMA: one multiply and one add (2 flops) per lane.
+__attribute__((target("sse2")))
+static double kernels_fma_sse2(double flops)
+{
+    const __m128d mul = _mm_set1_pd(kernels_fma_mul), add = _mm_set1_pd(kernels_fma_add);
+    __m128d acc0 = _mm_setzero_pd(), acc1 = acc0, acc2 = acc0, acc3 = acc0, acc4 = acc0, acc5 = acc0, acc6 = acc0, acc7 = acc0;
+
+    // 8 accumulators x 2 lanes x 2 flops.
+    size_t iterations = (size_t) (flops / 32);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        acc0 = _mm_add_pd(_mm_mul_pd(acc0, mul), add);
+        acc1 = _mm_add_pd(_mm_mul_pd(acc1, mul), add);
+        acc2 = _mm_add_pd(_mm_mul_pd(acc2, mul), add);
+        acc3 = _mm_add_pd(_mm_mul_pd(acc3, mul), add);
+        acc4 = _mm_add_pd(_mm_mul_pd(acc4, mul), add);
+        acc5 = _mm_add_pd(_mm_mul_pd(acc5, mul), add);
+        acc6 = _mm_add_pd(_mm_mul_pd(acc6, mul), add);
+        acc7 = _mm_add_pd(_mm_mul_pd(acc7, mul), add);
+    }
+
+    __m128d acc = _mm_add_pd(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)),
+                             _mm_add_pd(_mm_add_pd(acc4, acc5), _mm_add_pd(acc6, acc7)));
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+
+    return lanes[0] + lanes[1] + kernels_fma_scalar(flops - iterations * 32.0);
+}
+
+template <unsigned int fmas>
+__attribute__((target("sse2")))
+static void kernels_triad_sse2(double *a, const double *b, const double *c, size_t elements)
+{
+    const __m128d s = _mm_set1_pd(kernels_triad_scalar);
+    const __m128d mul = _mm_set1_pd(kernels_fma_mul), add = _mm_set1_pd(kernels_fma_add);
+
+    size_t i = 0;
+    for (; i + 2 <= elements; i += 2)
+    {
+        __m128d x = _mm_add_pd(_mm_loadu_pd(b + i), _mm_mul_pd(s, _mm_loadu_pd(c + i)));
+        for (unsigned int k = 0; k < fmas; k++)
+            x = _mm_add_pd(_mm_mul_pd(x, mul), add);
+        _mm_storeu_pd(a + i, x);
+    }
+
+    kernels_triad_scalar_fmas<fmas>(a + i, b + i, c + i, elements - i);
+}
+
+/* AVX2 */
+__attribute__((target("avx2")))
+static size_t kernels_sum_avx2(const char *buffer, size_t bytes)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc0 = zero, acc1 = zero, acc2 = zero, acc3 = zero;
+
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128)
+    {
+        acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *) (buffer + i)), zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *) (buffer + i + 32)), zero));
+        acc2 = _mm256_add_epi64(acc2, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *) (buffer + i + 64)), zero));
+        acc3 = _mm256_add_epi64(acc3, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *) (buffer + i + 96)), zero));
+    }
+
+    __m256i acc = _mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3));
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, acc);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + kernels_sum_sse2(buffer + i, bytes - i);
+}
+
+__attribute__((target("avx2")))
+static void kernels_stream_avx2(char *buffer, size_t bytes)
+{
+    size_t head = std::min(bytes, (size_t) (-(uintptr_t) buffer & 31));
+    memset(buffer, 0, head);
+
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = head;
+    for (; i + 32 <= bytes; i += 32)
+        _mm256_stream_si256((__m256i *) (buffer + i), zero);
+
+    memset(buffer + i, 0, bytes - i);
+    _mm_sfence();
+}
+
+__attribute__((target("avx2,fma")))
+static double kernels_fma_avx2(double flops)
+{
+    const __m256d mul = _mm256_set1_pd(kernels_fma_mul), add = _mm256_set1_pd(kernels_fma_add);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = acc0, acc2 = acc0, acc3 = acc0, acc4 = acc0, acc5 = acc0, acc6 = acc0, acc7 = acc0;
+
+    // 8 accumulators x 4 lanes x 2 flops; enough independent FMAs to cover latency x ports.
+    size_t iterations = (size_t) (flops / 64);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        acc0 = _mm256_fmadd_pd(acc0, mul, add);
+        acc1 = _mm256_fmadd_pd(acc1, mul, add);
+        acc2 = _mm256_fmadd_pd(acc2, mul, add);
+        acc3 = _mm256_fmadd_pd(acc3, mul, add);
+        acc4 = _mm256_fmadd_pd(acc4, mul, add);
+        acc5 = _mm256_fmadd_pd(acc5, mul, add);
+        acc6 = _mm256_fmadd_pd(acc6, mul, add);
+        acc7 = _mm256_fmadd_pd(acc7, mul, add);
+    }
+
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)),
+                                _mm256_add_pd(_mm256_add_pd(acc4, acc5), _mm256_add_pd(acc6, acc7)));
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + kernels_fma_scalar(flops - iterations * 64.0);
+}
+
+template <unsigned int fmas>
+__attribute__((target("avx2,fma")))
+static void kernels_triad_avx2(double *a, const double *b, const double *c, size_t elements)
+{
+    const __m256d s = _mm256_set1_pd(kernels_triad_scalar);
+    const __m256d mul = _mm256_set1_pd(kernels_fma_mul), add = _mm256_set1_pd(kernels_fma_add);
+
+    size_t i = 0;
+    for (; i + 4 <= elements; i += 4)
+    {
+        __m256d x = _mm256_fmadd_pd(s, _mm256_loadu_pd(c + i), _mm256_loadu_pd(b + i));
+        for (unsigned int k = 0; k < fmas; k++)
+            x = _mm256_fmadd_pd(x, mul, add);
+        _mm256_storeu_pd(a + i, x);
+    }
+
+    kernels_triad_scalar_fmas<fmas>(a + i, b + i, c + i, elements - i);
+}
+
+/* AVX-512 (F + BW) */
+__attribute__((target("avx512f,avx512bw")))
+static size_t kernels_sum_avx512(const char *buffer, size_t bytes)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i acc0 = zero, acc1 = zero, acc2 = zero, acc3 = zero;
+
+    size_t i = 0;
+    for (; i + 256 <= bytes; i += 256)
+    {
+        acc0 = _mm512_add_epi64(acc0, _mm512_sad_epu8(_mm512_loadu_si512((const void *) (buffer + i)), zero));
+        acc1 = _mm512_add_epi64(acc1, _mm512_sad_epu8(_mm512_loadu_si512((const void *) (buffer + i + 64)), zero));
+        acc2 = _mm512_add_epi64(acc2, _mm512_sad_epu8(_mm512_loadu_si512((const void *) (buffer + i + 128)), zero));
+        acc3 = _mm512_add_epi64(acc3, _mm512_sad_epu8(_mm512_loadu_si512((const void *) (buffer + i + 192)), zero));
+    }
+
+    __m512i acc = _mm512_add_epi64(_mm512_add_epi64(acc0, acc1), _mm512_add_epi64(acc2, acc3));
+
+    uint64_t lanes[8];
+    _mm512_storeu_si512((void *) lanes, acc);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7]
+        + kernels_sum_avx2(buffer + i, bytes - i);
+}
+
+__attribute__((target("avx512f")))
+static void kernels_stream_avx512(char *buffer, size_t bytes)
+{
+    size_t head = std::min(bytes, (size_t) (-(uintptr_t) buffer & 63));
+    memset(buffer, 0, head);
+
+    const __m512i zero = _mm512_setzero_si512();
+
+    size_t i = head;
+    for (; i + 64 <= bytes; i += 64)
+        _mm512_stream_si512((__m512i *) (buffer + i), zero);
+
+    memset(buffer + i, 0, bytes - i);
+    _mm_sfence();
+}
+
+__attribute__((target("avx512f")))
+static double kernels_fma_avx512(double flops)
+{
+    const __m512d mul = _mm512_set1_pd(kernels_fma_mul), add = _mm512_set1_pd(kernels_fma_add);
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = acc0, acc2 = acc0, acc3 = acc0, acc4 = acc0, acc5 = acc0, acc6 = acc0, acc7 = acc0;
+
+    // 8 accumulators x 8 lanes x 2 flops.
+    size_t iterations = (size_t) (flops / 128);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        acc0 = _mm512_fmadd_pd(acc0, mul, add);
+        acc1 = _mm512_fmadd_pd(acc1, mul, add);
+        acc2 = _mm512_fmadd_pd(acc2, mul, add);
+        acc3 = _mm512_fmadd_pd(acc3, mul, add);
+        acc4 = _mm512_fmadd_pd(acc4, mul, add);
+        acc5 = _mm512_fmadd_pd(acc5, mul, add);
+        acc6 = _mm512_fmadd_pd(acc6, mul, add);
+        acc7 = _mm512_fmadd_pd(acc7, mul, add);
+    }
+
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)),
+                                _mm512_add_pd(_mm512_add_pd(acc4, acc5), _mm512_add_pd(acc6, acc7)));
+
+    double lanes[8];
+    _mm512_storeu_pd(lanes, acc);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7]
+        + kernels_fma_scalar(flops - iterations * 128.0);
+}
+
+template <unsigned int fmas>
+__attribute__((target("avx512f")))
+static void kernels_triad_avx512(double *a, const double *b, const double *c, size_t elements)
+{
+    const __m512d s = _mm512_set1_pd(kernels_triad_scalar);
+    const __m512d mul = _mm512_set1_pd(kernels_fma_mul), add = _mm512_set1_pd(kernels_fma_add);
+
+    size_t i = 0;
+    for (; i + 8 <= elements; i += 8)
+    {
+        __m512d x = _mm512_fmadd_pd(s, _mm512_loadu_pd(c + i), _mm512_loadu_pd(b + i));
+        for (unsigned int k = 0; k < fmas; k++)
+            x = _mm512_fmadd_pd(x, mul, add);
+        _mm512_storeu_pd(a + i, x);
+    }
+
+    kernels_triad_scalar_fmas<fmas>(a + i, b + i, c + i, elements - i);
+}
+#endif
+
+static kernels_ops_t kernels_ops_get(kernels_isa_t isa)
+{
+    switch (isa) {
+#ifdef KERNELS_X86
+        case KERNELS_ISA_AVX512:
+            return {kernels_sum_avx512, kernels_stream_avx512, kernels_fma_avx512,
+                    kernels_triad_avx512<0>, kernels_triad_avx512<KERNELS_MIXED_FMAS>};
+        case KERNELS_ISA_AVX2:
+            return {kernels_sum_avx2, kernels_stream_avx2, kernels_fma_avx2,
+                    kernels_triad_avx2<0>, kernels_triad_avx2<KERNELS_MIXED_FMAS>};
+        case KERNELS_ISA_SSE2:
+            return {kernels_sum_sse2, kernels_stream_sse2, kernels_fma_sse2,
+                    kernels_triad_sse2<0>, kernels_triad_sse2<KERNELS_MIXED_FMAS>};
+#endif
+        default:
+            return {kernels_sum_scalar, kernels_stream_scalar, kernels_fma_scalar,
+                    kernels_triad_scalar_fmas<0>, kernels_triad_scalar_fmas<KERNELS_MIXED_FMAS>};
+    }
+}
+
+kernels_isa_t kernels_isa_detect()
+{
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+
+    bool fma = __builtin_cpu_supports("fma");
+
+    if (fma && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return KERNELS_ISA_AVX512;
+    if (fma && __builtin_cpu_supports("avx2")) return KERNELS_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2")) return KERNELS_ISA_SSE2;
+#endif
+
+    return KERNELS_ISA_SCALAR;
+}
+
+kernels_isa_t kernels_isa_str_to_type(const std::string &type)
+{
+    if (type.compare("scalar") == 0) return KERNELS_ISA_SCALAR;
+    if (type.compare("sse2") == 0) return KERNELS_ISA_SSE2;
+    if (type.compare("avx2") == 0) return KERNELS_ISA_AVX2;
+    if (type.compare("avx512") == 0) return KERNELS_ISA_AVX512;
+
+    XBT_ERROR("Unsupported kernels isa type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported kernels isa type '" + type + "'.");
+}
+
+std::string kernels_isa_type_to_str(const kernels_isa_t &type)
+{
+    switch (type) {
+        case KERNELS_ISA_SCALAR: return "scalar";
+        case KERNELS_ISA_SSE2: return "sse2";
+        case KERNELS_ISA_AVX2: return "avx2";
+        case KERNELS_ISA_AVX512: return "avx512";
+        default: return "";
+    }
+}
+
+kernels_read_pattern_t kernels_read_pattern_str_to_type(const std::string &type)
+{
+    if (type.compare("sequential") == 0) return KERNELS_READ_SEQUENTIAL;
+    if (type.compare("strided") == 0) return KERNELS_READ_STRIDED;
+    if (type.compare("gather") == 0) return KERNELS_READ_GATHER;
+    if (type.compare("pointer-chase") == 0) return KERNELS_READ_POINTER_CHASE;
+
+    XBT_ERROR("Unsupported read pattern type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported read pattern type '" + type + "'.");
+}
+
+std::string kernels_read_pattern_type_to_str(const kernels_read_pattern_t &type)
+{
+    switch (type) {
+        case KERNELS_READ_SEQUENTIAL: return "sequential";
+        case KERNELS_READ_STRIDED: return "strided";
+        case KERNELS_READ_GATHER: return "gather";
+        case KERNELS_READ_POINTER_CHASE: return "pointer-chase";
+        default: return "";
+    }
+}
+
+kernels_write_pattern_t kernels_write_pattern_str_to_type(const std::string &type)
+{
+    if (type.compare("temporal") == 0) return KERNELS_WRITE_TEMPORAL;
+    if (type.compare("non-temporal") == 0) return KERNELS_WRITE_NON_TEMPORAL;
+
+    XBT_ERROR("Unsupported write pattern type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported write pattern type '" + type + "'.");
+}
+
+std::string kernels_write_pattern_type_to_str(const kernels_write_pattern_t &type)
+{
+    switch (type) {
+        case KERNELS_WRITE_TEMPORAL: return "temporal";
+        case KERNELS_WRITE_NON_TEMPORAL: return "non-temporal";
+        default: return "";
+    }
+}
+
+kernels_compute_pattern_t kernels_compute_pattern_str_to_type(const std::string &type)
+{
+    if (type.compare("fma") == 0) return KERNELS_COMPUTE_FMA;
+    if (type.compare("triad") == 0) return KERNELS_COMPUTE_TRIAD;
+    if (type.compare("mixed") == 0) return KERNELS_COMPUTE_MIXED;
+
+    XBT_ERROR("Unsupported compute pattern type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported compute pattern type '" + type + "'.");
+}
+
+std::string kernels_compute_pattern_type_to_str(const kernels_compute_pattern_t &type)
+{
+    switch (type) {
+        case KERNELS_COMPUTE_FMA: return "fma";
+        case KERNELS_COMPUTE_TRIAD: return "triad";
+        case KERNELS_COMPUTE_MIXED: return "mixed";
+        default: return "";
+    }
+}
+
+/**
+ * @brief Read every byte of a buffer following an access pattern.
+ *
+ * The buffer is split in cache lines; the pattern only changes the order in which
+ * lines are visited (the trailing partial line is always read last).
+ *
+ * @param stride_bytes Distance between consecutive lines of the strided pattern (rounded down to lines).
+ * @return Sum of the bytes read (checksum), except for pointer-chase, which sums the first 8 bytes of each visited line.
+ */
+size_t kernels_read(kernels_isa_t isa, kernels_read_pattern_t pattern, const char *buffer, size_t bytes, size_t stride_bytes)
+{
+    const kernels_ops_t ops = kernels_ops_get(isa);
+
+    size_t lines = bytes / KERNELS_CACHE_LINE_BYTES;
+    size_t tail_bytes = bytes % KERNELS_CACHE_LINE_BYTES;
+    const char *tail = buffer + lines * KERNELS_CACHE_LINE_BYTES;
+
+    if (pattern == KERNELS_READ_SEQUENTIAL || lines == 0)
+        return ops.sum(buffer, bytes);
+
+    // Smallest power of two >= lines; indexes are generated modulo span.
+    size_t span = 1;
+    while (span < lines) span <<= 1;
+    const size_t mask = span - 1;
+
+    // Full-period LCG modulo a power of two (c odd, a = 1 mod 4): visits each index in [0, span) once.
+    auto lcg_next = [mask](size_t index) { return (size_t) (index * 6364136223846793005ULL + 1442695040888963407ULL) & mask; };
+
+    size_t checksum = 0;
+
+    switch (pattern) {
+        case KERNELS_READ_STRIDED:
+        {
+            size_t stride_lines = std::max((size_t) 1, stride_bytes / KERNELS_CACHE_LINE_BYTES);
+
+            for (size_t first_line = 0; first_line < std::min(stride_lines, lines); first_line++)
+                for (size_t line = first_line; line < lines; line += stride_lines)
+                    checksum += ops.sum(buffer + line * KERNELS_CACHE_LINE_BYTES, KERNELS_CACHE_LINE_BYTES);
+            break;
+        }
+        case KERNELS_READ_GATHER:
+        {
+            size_t line = 0;
+            for (size_t i = 0; i < span; i++)
+            {
+                line = lcg_next(line);
+                if (line < lines)
+                    checksum += ops.sum(buffer + line * KERNELS_CACHE_LINE_BYTES, KERNELS_CACHE_LINE_BYTES);
+            }
+            break;
+        }
+        case KERNELS_READ_POINTER_CHASE:
+        {
+            // The loaded word is mixed into the next index, so each load waits for the previous one.
+            // Indexes in [lines, span) are folded into [0, span / 2), which is below lines.
+            size_t line = 0;
+            for (size_t i = 0; i < lines; i++)
+            {
+                uint64_t word;
+                memcpy(&word, buffer + line * KERNELS_CACHE_LINE_BYTES, sizeof(word));
+                checksum += kernels_sum_scalar((const char *) &word, sizeof(word));
+
+                line = (lcg_next(line) + word) & mask;
+                if (line >= lines) line -= span / 2;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return checksum + ops.sum(tail, tail_bytes);
+}
+
+/**
+ * @brief Write (zero) every byte of a buffer with regular or non-temporal stores.
+ */
+void kernels_write(kernels_isa_t isa, kernels_write_pattern_t pattern, char *buffer, size_t bytes)
+{
+    if (pattern == KERNELS_WRITE_NON_TEMPORAL)
+    {
+        kernels_ops_get(isa).stream(buffer, bytes);
+        return;
+    }
+
+    memset(buffer, 0, bytes);
+}
+
+static double kernels_compute_flops_per_element(kernels_compute_pattern_t pattern)
+{
+    return (pattern == KERNELS_COMPUTE_MIXED) ? 2.0 + 2.0 * KERNELS_MIXED_FMAS : 2.0;
+}
+
+/**
+ * @brief Prepare a compute kernel for (up to) flops operations.
+ *
+ * Triad and mixed allocate three arrays of min(flops / flops_per_element, KERNELS_TRIAD_MAX_ELEMENTS)
+ * elements and touch them, so pages are placed by the calling thread before any timing starts.
+ */
+void kernels_compute_initialize(kernels_compute_t &compute, kernels_isa_t isa, kernels_compute_pattern_t pattern, double flops)
+{
+    compute = {isa, pattern, nullptr, nullptr, nullptr, 0};
+
+    if (pattern == KERNELS_COMPUTE_FMA) return;
+
+    compute.elements = std::min((size_t) KERNELS_TRIAD_MAX_ELEMENTS, (size_t) (flops / kernels_compute_flops_per_element(pattern)));
+    if (compute.elements == 0) return;
+
+    size_t bytes = (compute.elements * sizeof(double) + KERNELS_CACHE_LINE_BYTES - 1) / KERNELS_CACHE_LINE_BYTES * KERNELS_CACHE_LINE_BYTES;
+    compute.a = (double *) aligned_alloc(KERNELS_CACHE_LINE_BYTES, bytes);
+    compute.b = (double *) aligned_alloc(KERNELS_CACHE_LINE_BYTES, bytes);
+    compute.c = (double *) aligned_alloc(KERNELS_CACHE_LINE_BYTES, bytes);
+
+    if (!compute.a || !compute.b || !compute.c)
+    {
+        kernels_compute_finalize(compute);
+        XBT_ERROR("unable to allocate %zu bytes for the %s kernel.", 3 * bytes, kernels_compute_pattern_type_to_str(pattern).c_str());
+        throw std::runtime_error("unable to allocate compute kernel arrays.");
+    }
+
+    std::fill(compute.a, compute.a + compute.elements, 0.0);
+    std::fill(compute.b, compute.b + compute.elements, 1.0);
+    std::fill(compute.c, compute.c + compute.elements, 2.0);
+}
+
+/**
+ * @brief Perform flops floating-point operations with the prepared kernel.
+ *
+ * Triad and mixed sweep the arrays as many times as needed to reach flops.
+ *
+ * @return A value depending on every operation (keeps the work observable).
+ */
+double kernels_compute(const kernels_compute_t &compute, double flops)
+{
+    const kernels_ops_t ops = kernels_ops_get(compute.isa);
+
+    if (compute.pattern == KERNELS_COMPUTE_FMA)
+        return ops.fma(flops);
+
+    if (compute.elements == 0)
+        return 0.0;
+
+    kernels_triad_t triad = (compute.pattern == KERNELS_COMPUTE_TRIAD) ? ops.triad : ops.mixed;
+
+    size_t elements = (size_t) (flops / kernels_compute_flops_per_element(compute.pattern));
+    while (elements > 0)
+    {
+        size_t sweep_elements = std::min(elements, compute.elements);
+        triad(compute.a, compute.b, compute.c, sweep_elements);
+        elements -= sweep_elements;
+    }
+
+    return compute.a[0];
+}
+
+void kernels_compute_finalize(kernels_compute_t &compute)
+{
+    free(compute.a);
+    free(compute.b);
+    free(compute.c);
+
+    compute.a = compute.b = compute.c = nullptr;
+    compute.elements = 0;
+}
@@ -14,9 +14,21 @@ int main(int argc, char *argv[])
     mapper_t *mapper = nullptr;
 
     try {
-        runtime_initialize(&common, &dag, &scheduler, &mapper, argv[1]);
-        runtime_start(&mapper);
-        runtime_stop(&common);
+        if (argc > 1 && std::string(argv[1]) == "--calibrate") {
+            // nflows --calibrate [latency_ns.txt] [bandwidth_gbps.txt] [buffer_mib]
+            runtime_calibrate(&common, argc > 2 ? argv[2] : "latency_ns.txt", argc > 3 ? argv[3] : "bandwidth_gbps.txt",
+                argc > 4 ? std::stoul(argv[4]) : 256);
+        } else if (argc > 2 && std::string(argv[1]) == "--sweep") {
+            // nflows --sweep sweep.json
+            runtime_sweep(&common, &dag, argv[2]);
+        } else if (argc > 3 && std::string(argv[1]) == "--convert-dag") {
+            // nflows --convert-dag workflow.dot workflow.nfdag
+            runtime_convert_dag(&common, &dag, argv[2], argv[3]);
+        } else {
+            runtime_initialize(&common, &dag, &scheduler, &mapper, argv[1]);
+            runtime_start(&mapper);
+            runtime_stop(&common);
+        }
         runtime_finalize(&common, &dag, &scheduler, &mapper);
     }
     catch (const std::out_of_range &e) {
@@ -2,7 +2,8 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(mapper_bare_metal, "Messages specific to this module.");
 
-Mapper_Bare_Metal::Mapper_Bare_Metal(common_t *common, scheduler_t &scheduler) : Mapper_Base(common, scheduler)
+Mapper_Bare_Metal::Mapper_Bare_Metal(common_t *common, scheduler_t &scheduler, simgrid_execs_t &dag)
+    : Mapper_Base(common, scheduler, dag)
 {
     this->set_thread_func_ptr(mapper_bare_metal_thread_function);
 }
@@ -14,92 +15,146 @@ Mapper_Bare_Metal::~Mapper_Bare_Metal()
 void Mapper_Bare_Metal::start()
 {
     XBT_INFO("Start mapper_bare_metal");
-    simgrid_exec_t *selected_exec;
+    int selected_exec_id;
     int selected_core_id;
     unsigned long estimated_completion_time;
 
-    // Timer for selected_execs timeout
-    size_t selected_execs_timeout_s = 0;
-    size_t selected_execs_timeout_max_s = 900; // 15 minutes
-
-    // Timer for selected_core_id timeout
-    size_t selected_core_id_timeout_s = 0;
-    size_t selected_core_id_timeout_max_s = 900; // 15 minutes
+    // The mapper must make progress (dispatch an exec) before this deadline; 15 minutes.
+    time_t dispatch_timeout_s = 900;
+    struct timespec dispatch_deadline = common_deadline_from_now(dispatch_timeout_s);
 
     // Mandatory previous to initiate any scheduling activity.
     this->scheduler.initialize();
 
+    if (this->common->mapper_thread_pool)
+        hardware_worker_pool_start(this->common, this->worker_pool, this->thread_func_ptr);
+
+    hardware_prefetcher_start(this->common);
+
     while (this->scheduler.has_next())
     {
-        std::tie(selected_exec, selected_core_id, estimated_completion_time) = this->scheduler.next();
+        // A thread failed (e.g., unable to create a write buffer); its successors will never be ready.
+        if (common_threads_failed_get(this->common) > 0) break;
+
+        // Read before asking the scheduler, so a completion in between wakes the wait below at once.
+        unsigned long threads_completed_seen = common_threads_completed_get(this->common);
 
-        if (!selected_exec)
+        common_scheduler_decision_begin(this->common);
+        std::tie(selected_exec_id, selected_core_id, estimated_completion_time) = this->scheduler.next();
+        common_scheduler_decision_end(this->common);
+
+        if (selected_exec_id == -1)
         {
-            XBT_INFO("There are not ready tasks, waiting 5 seconds.");
-            selected_execs_timeout_s += 5;
+            XBT_INFO("There are not ready tasks, waiting for a task to finish.");
 
-            if (selected_execs_timeout_s > selected_execs_timeout_max_s)
+            if (!common_threads_completed_wait(this->common, threads_completed_seen, dispatch_deadline))
             {
                 XBT_ERROR("Timeout waiting for a selected_exec.");
                 throw std::runtime_error("Timeout waiting for a selected_exec.");
             }
 
-            sleep(5);
             continue;
         }
-        else
-        {
-            selected_execs_timeout_s = 0;
-        }
 
         if (selected_core_id == -1)
         {
-            XBT_INFO("There are not available cores, waiting 5 seconds.");
-            selected_core_id_timeout_s += 5;
+            XBT_INFO("There are not available cores, waiting for a task to finish.");
 
-            if (selected_core_id_timeout_s > selected_core_id_timeout_max_s)
+            if (!common_threads_completed_wait(this->common, threads_completed_seen, dispatch_deadline))
             {
                 XBT_ERROR("Timeout waiting for a selected_core_id.");
                 throw std::runtime_error("Timeout waiting for a selected_core_id.");
             }
 
-            sleep(5);
             continue;
         }
-        else
+
+        dispatch_deadline = common_deadline_from_now(dispatch_timeout_s);
+
+        // Set as assigned.
+        if (this->dag[selected_exec_id]) this->dag[selected_exec_id]->set_host(this->dummy_host);
+        common_exec_id_to_core_id_create(this->common, selected_exec_id, selected_core_id);
+
+        // Migrate the inputs worth moving to the NUMA node of the selected core while it starts.
+        if (this->common->mapper_prefetch)
+            this->prefetch(selected_exec_id, selected_core_id);
+
+        if (this->common->mapper_thread_pool)
         {
-            selected_core_id_timeout_s = 0;
+            hardware_worker_pool_submit(this->worker_pool, selected_core_id, selected_exec_id, this->dag[selected_exec_id]);
+            continue;
         }
 
         // Initialize thread data.
-        // data is free'd by the thread at the end of the execution.
+        // data is free'd when the thread finishes the execution.
         thread_data_t *data = (thread_data_t *)malloc(sizeof(thread_data_t));
-        data->exec = selected_exec;
+        data->exec_id = selected_exec_id;
+        data->exec = this->dag[selected_exec_id];
         data->assigned_core_id = selected_core_id;
         data->common = this->common;
         data->thread_function = this->thread_func_ptr;
 
-        // Set as assigned.
-        selected_exec->set_host(this->dummy_host);
         hardware_hwloc_thread_bind_to_core_id(data);
     }
 
     common_threads_active_wait(this->common);
 
+    hardware_prefetcher_stop(this->common);
+
+    if (this->common->mapper_thread_pool)
+        hardware_worker_pool_stop(this->worker_pool);
+
+    unsigned int threads_failed = common_threads_failed_get(this->common);
+    if (threads_failed > 0)
+    {
+        XBT_ERROR("%u thread(s) failed, the workflow was not completed.", threads_failed);
+        throw std::runtime_error("thread(s) failed, the workflow was not completed.");
+    }
+
     // Workaround to properly finalize SimGrid resources.
-    simgrid::s4u::Engine *e = simgrid::s4u::Engine::get_instance();
-    e->run();
+    if (this->has_simgrid_execs())
+    {
+        simgrid::s4u::Engine *e = simgrid::s4u::Engine::get_instance();
+        e->run();
+    }
 
     XBT_INFO("End mapper_bare_metal");
 }
 
+/**
+ * @brief Queue the migration of the in-comms of exec_id that are cheaper to migrate than to read remotely.
+ *
+ * The target NUMA node is only known once the exec is assigned, so prefetching starts here
+ * rather than when the exec becomes ready. The decision uses the same cost model as the scheduler.
+ */
+void Mapper_Bare_Metal::prefetch(unsigned int exec_id, int core_id)
+{
+    int numa_id = hardware_hwloc_numa_id_get_by_core_id(this->common, core_id);
+    double earliest_start_time_us = common_earliest_start_time(this->common, exec_id, core_id);
+
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(this->common, exec_id))
+    {
+        double migration_time_us;
+        common_comm_id_read_time(this->common, comm_id, numa_id, earliest_start_time_us, &migration_time_us);
+
+        if (migration_time_us > 0.0)
+        {
+            XBT_DEBUG("prefetch: %s, dst_numa_id: %d, estimated_migration_time_us: %f",
+                this->common->workflow.comm_names[comm_id].c_str(), numa_id, migration_time_us);
+
+            hardware_prefetcher_submit(this->common, comm_id, numa_id);
+        }
+    }
+}
+
 /**
  * @brief Emulate the activities involved in executing a workflow task.
  *
  * 1. Read the required data from memory by accessing a previously created address.
  *    Reads are performed sequentially, but the time recorded assumes they were performed in parallel.
+ *    With mapper_prefetch, the wait for a pending migration of the data item is part of its read time.
  *
- * 2. Perform the FMA (Fused Multiply-Add) operation to emulate computation.
+ * 2. Run the configured compute kernel (FMA, triad or mixed) to emulate computation.
  *
  * 3. Write the required data to memory, creating a pointer to be accessed by successor tasks.
  *    Writes are performed sequentially, but the time recorded assumes they were performed in parallel.
@@ -107,6 +162,7 @@ void Mapper_Bare_Metal::start()
  * 4. Record the read, write, and execution times.
  *
  * 5. Save thread locality information, including the NUMA node ids, core ID, and context switches.
+ *    With mapper_perf_counters, the counters of each phase (read, compute, write) are saved as well.
  *
  * @param arg Structure used to collect thread execution data.
  * @return void*
@@ -120,7 +176,9 @@ void *mapper_bare_metal_thread_function(void *arg)
     thread_data_t* data = ((thread_data_t *) arg);
 
     common_t *common = data->common;
-    simgrid_exec_t *exec = data->exec;
+    const workflow_t &workflow = common->workflow;
+    unsigned int exec_id = data->exec_id;
+    const char *exec_name = workflow.exec_names[exec_id].c_str();
     int assigned_core_id = data->assigned_core_id;
     
     std::vector<int> mem_bind_numa_ids;
@@ -137,36 +195,46 @@ void *mapper_bare_metal_thread_function(void *arg)
         std::runtime_error("thread_core_id != assigned_core_id");
     }
 
-    XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => message: started.", thread_pid, thread_tid, exec->get_cname(), thread_core_id);
-    XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => thread_mem_policy: %s.", thread_pid, thread_tid, exec->get_cname(), thread_core_id, thread_mem_policy.c_str());
+    XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => message: started.", thread_pid, thread_tid, exec_name, thread_core_id);
+    XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => thread_mem_policy: %s.", thread_pid, thread_tid, exec_name, thread_core_id, thread_mem_policy.c_str());
+
+    double earliest_start_time_us = common_earliest_start_time(common, exec_id, assigned_core_id);
 
-    double earliest_start_time_us = common_earliest_start_time(common, exec->get_name(), assigned_core_id);
+    // Performance counters of this thread, recorded at the end of each phase (mapper_perf_counters).
+    std::vector<double> perf_counter_values;
+    if (common->mapper_perf_counters)
+        hardware_perf_counters_sample(common, perf_counter_values);
 
     /* EMULATE MEMORY READING */
     double actual_read_time_us = 0.0;
 
-    // Match all communication (Task1->Task2) where this task_name is the destination.
-    name_to_time_range_payload_t matches = common_comm_name_to_w_time_offset_payload_filter(common, exec->get_name());
-
-    for (const auto &[comm_name, time_range_payload] : matches)
+    // All communications (Task1->Task2) where this task is the destination.
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(common, exec_id))
     {
-        char *read_buffer = common_comm_name_to_address_get(common, comm_name);
+        const char *comm_name = workflow.comm_names[comm_id].c_str();
+
+        char *read_buffer = common_comm_id_to_address_get(common, comm_id);
         
-        double read_payload_bytes = std::get<2>(time_range_payload);
+        double read_payload_bytes = std::get<2>(common_comm_id_to_w_time_offset_payload_get(common, comm_id));
+
+        // Wait for the prefetcher if the data item is being migrated to this NUMA node.
+        double migration_time_us;
+        double migration_wait_time_us = hardware_prefetcher_wait(common, comm_id, &migration_time_us);
 
         // Used to check data (pages) migration.
         std::vector<int> nlbr = hardware_hwloc_numa_id_get_by_address(common, read_buffer, read_payload_bytes);
 
         double read_start_timestemp_us = common_get_time_us();
 
-        size_t checksum = 0;
-        for (size_t i = 0; i < read_payload_bytes; i++)
-            checksum += read_buffer[i]; // Access each byte in the buffer (simulates reading)
+        // Access each byte in the buffer (simulates reading) following the configured pattern.
+        size_t checksum = kernels_read(common->mapper_kernels_isa, common->mapper_read_pattern_type,
+            read_buffer, (size_t) read_payload_bytes, common->mapper_read_stride_bytes);
 
         double read_end_timestemp_us = common_get_time_us();
 
-        XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => read: %s, payload (bytes): %f, checksum: %ld", 
-            thread_pid, thread_tid, exec->get_cname(), thread_core_id, comm_name.c_str(), read_payload_bytes, checksum);
+        XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => read: %s, payload (bytes): %f, pattern: %s, checksum: %ld", 
+            thread_pid, thread_tid, exec_name, thread_core_id, comm_name, read_payload_bytes,
+            kernels_read_pattern_type_to_str(common->mapper_read_pattern_type).c_str(), checksum);
 
         // Used to check data (pages) migration. Migration is trigered once the data is being read.
         std::vector<int> nlar = hardware_hwloc_numa_id_get_by_address(common, read_buffer, read_payload_bytes);
@@ -175,48 +243,69 @@ void *mapper_bare_metal_thread_function(void *arg)
         common_threads_checksum_update(common, checksum);
 
         // Save read data locality.
-        common_comm_name_to_numa_ids_r_create(common, comm_name, nlar); 
+        common_comm_id_to_numa_ids_r_create(common, comm_id, nlar); 
 
         // Save read timestamps.
         time_range_payload_t read_ts_range_payload = time_range_payload_t(read_start_timestemp_us, read_end_timestemp_us, read_payload_bytes);
-        common_comm_name_to_r_ts_range_payload_create(common, comm_name, read_ts_range_payload);
+        common_comm_id_to_r_ts_range_payload_create(common, comm_id, read_ts_range_payload);
+
+        double read_time_us = migration_wait_time_us + (read_end_timestemp_us - read_start_timestemp_us);
 
         // Save read time offset.
         time_range_payload_t read_of_payload = time_range_payload_t(
-            earliest_start_time_us, earliest_start_time_us + (read_end_timestemp_us - read_start_timestemp_us), read_payload_bytes);
-        common_comm_name_to_r_time_offset_payload_create(common, comm_name, read_of_payload);
+            earliest_start_time_us, earliest_start_time_us + read_time_us, read_payload_bytes);
+        common_comm_id_to_r_time_offset_payload_create(common, comm_id, read_of_payload);
+
+        // Save migration time offset (it ends when the read can start, and cannot start before the write ends).
+        if (migration_time_us > 0.0)
+        {
+            double write_end_time_us = std::get<1>(common_comm_id_to_w_time_offset_payload_get(common, comm_id));
+            double migration_end_time_us = earliest_start_time_us + migration_wait_time_us;
+            time_range_payload_t migration_of_payload = time_range_payload_t(
+                std::max(write_end_time_us, migration_end_time_us - migration_time_us), migration_end_time_us, read_payload_bytes);
+            common_comm_id_to_m_time_offset_payload_create(common, comm_id, migration_of_payload);
+        }
 
-        actual_read_time_us = std::max(actual_read_time_us, read_end_timestemp_us - read_start_timestemp_us);
+        actual_read_time_us = std::max(actual_read_time_us, read_time_us);
         
         XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => read: %s, numa_locality_before_read: [%s], numa_locality_after_read: [%s], pages_migration: %s",
-            thread_pid, thread_tid, exec->get_cname(), thread_core_id, comm_name.c_str(), common_join(nlbr).c_str(), common_join(nlar).c_str(), nlbr != nlar ? "yes" : "no");
+            thread_pid, thread_tid, exec_name, thread_core_id, comm_name, common_join(nlbr).c_str(), common_join(nlar).c_str(), nlbr != nlar ? "yes" : "no");
 
-        common_reads_active_increment(common, comm_name);
+        common_reads_active_increment(common, comm_id);
 
-        // Clean up.
-        free(read_buffer);
+        // Clean up (the block goes back to the NUMA arena, if enabled).
+        hardware_numa_arena_free(common, read_buffer);
     }
 
+    hardware_perf_counters_record(common, exec_id, COMMON_PHASE_READ, perf_counter_values);
+
     /* EMULATE COMPUTATION */
-    double flops = exec->get_remaining();
+    double flops = workflow.exec_flops[exec_id];
 
-    // The volatile keyword is used to prevent the compiler from optimizing away the floating-point operations.
-    volatile double a = 1.0, b = 2.0, c = 0.0;
+    // Kernel arrays (triad, mixed) are allocated and touched before timing starts.
+    kernels_compute_t compute;
+    kernels_compute_initialize(compute, common->mapper_kernels_isa, common->mapper_compute_pattern_type, flops);
 
     double exec_start_timestamp_us = common_get_time_us();
 
-    // FMA (Fused Multiply-Add) operation. This is a common pattern in scientific computing
-    // benchmarks (e.g., LINPACK)
-    for (uint64_t i = 0; i < flops; ++i) c = a * b + c;
+    // FMA (Fused Multiply-Add) operations on independent accumulators, a STREAM triad, or both.
+    double compute_result = kernels_compute(compute, flops);
 
     double exec_end_timestamp_us = common_get_time_us();
 
+    hardware_perf_counters_record(common, exec_id, COMMON_PHASE_COMPUTE, perf_counter_values);
+
+    kernels_compute_finalize(compute);
+
+    XBT_DEBUG("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => compute result: %f",
+        thread_pid, thread_tid, exec_name, thread_core_id, compute_result);
+
     // Calculate the compute time in microseconds.
     double compute_time_us = exec_end_timestamp_us - exec_start_timestamp_us;
 
     // Save compute timestamps.
     time_range_payload_t exec_ts_range_payload = time_range_payload_t{exec_start_timestamp_us, exec_end_timestamp_us, flops};
-    common_exec_name_to_c_ts_range_payload_create(common, exec->get_name(), exec_ts_range_payload);
+    common_exec_id_to_c_ts_range_payload_create(common, exec_id, exec_ts_range_payload);
 
     // Save compute offsets.
     time_range_payload_t exec_of_range_payload = time_range_payload_t{
@@ -225,64 +314,54 @@ void *mapper_bare_metal_thread_function(void *arg)
         flops
     };
 
-    common_exec_name_to_c_time_offset_payload_create(common, exec->get_name(), exec_of_range_payload);
+    common_exec_id_to_c_time_offset_payload_create(common, exec_id, exec_of_range_payload);
 
-    common_execs_active_increment(common, exec->get_name());
+    common_execs_active_increment(common, exec_id);
 
     /* EMULATE MEMORY WRITTING */
     double actual_write_time_us = 0.0;
 
-    for (const auto &succ_ptr : exec->get_successors())
+    // task_i->end communications are not part of the workflow comms.
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(common, exec_id))
     {
-        const simgrid_activity_t *succ = succ_ptr.get();
-        auto [exec_name, succ_exec_name] = common_split(succ->get_cname(), "->");
+        const char *comm_name = workflow.comm_names[comm_id].c_str();
 
-        if (succ_exec_name == std::string("end")) continue;
-
-        double write_payload_bytes = succ->get_remaining();
+        double write_payload_bytes = workflow.comm_payloads[comm_id];
 
         // Emulate memory writting by saving data into memory.
-        char *write_buffer = (char *)malloc(write_payload_bytes);
+        // With the NUMA arena, the buffer is a (possibly recycled) block bound to a deterministic node.
+        int write_numa_id = hardware_numa_arena_numa_id_get(common, comm_id, thread_core_id);
+        char *write_buffer = hardware_numa_arena_alloc(common, (size_t) write_payload_bytes, write_numa_id);
 
         if (!write_buffer)
         {
             XBT_ERROR("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => write: %s, message: unable to create write buffer.",
-                thread_pid, thread_tid, exec->get_cname(), thread_core_id, succ->get_cname());
+                thread_pid, thread_tid, exec_name, thread_core_id, comm_name);
+
+            // Record the failure, release the core and signal the mapper, so it stops dispatching
+            // (the successors of this exec will never be released) instead of waiting forever.
+            common_threads_failed_increment(common);
+            common_core_id_set_avail(common, assigned_core_id, true);
+            common_threads_active_decrement(common);
 
             return NULL;
         }
 
-        /*
-        memset:
-        Fills a block of memory with a specified value, typically used to initialize memory, such as setting
-        all elements of an array to zero or preparing data structures.
-
-        Parameters:
-            ptr   - Pointer to the memory block to fill.
-            value - The value to set, interpreted as an unsigned char (0-255). Although passed as an int,
-                    the value is converted to an unsigned char to fill the memory block.
-            num   - The number of bytes to set in the memory block.
-
-        Description:
-        memset sets each byte of the memory block starting at ptr to the given value. When an integer is
-        provided, it is truncated to the least significant 8 bits (one byte), and this byte is used to
-        fill the entire block.
-        */
-
         double write_start_timestamp_us = common_get_time_us();
 
-        memset(write_buffer, 0, write_payload_bytes);
+        // Zero the buffer with regular (memset) or non-temporal stores.
+        kernels_write(common->mapper_kernels_isa, common->mapper_write_pattern_type, write_buffer, (size_t) write_payload_bytes);
 
         double write_end_timestamp_us = common_get_time_us();
 
         // Save address for subsequent reading.
-        common_comm_name_to_address_create(common, succ->get_name(), write_buffer);
+        common_comm_id_to_address_create(common, comm_id, write_buffer);
 
         // Get data numa locality.
         std::vector<int> nlaw = hardware_hwloc_numa_id_get_by_address(data->common, write_buffer, write_payload_bytes);
 
         // Save data locality.
-        common_comm_name_to_numa_ids_w_create(common, succ->get_name(), nlaw);
+        common_comm_id_to_numa_ids_w_create(common, comm_id, nlaw);
 
         // Compute write time, assuming reads are carried out in parallel.
         // The total read time is determined by the longest individual read time.
@@ -291,7 +370,7 @@ void *mapper_bare_metal_thread_function(void *arg)
         // Save write timestamps.
         time_range_payload_t write_ts_range_payload = time_range_payload_t{write_start_timestamp_us, write_end_timestamp_us, write_payload_bytes};
 
-        common_comm_name_to_w_ts_range_payload_create(common, succ->get_name(), write_ts_range_payload);
+        common_comm_id_to_w_ts_range_payload_create(common, comm_id, write_ts_range_payload);
 
         // Save write offsets.
         time_range_payload_t write_of_range_payload = time_range_payload_t(
@@ -299,47 +378,52 @@ void *mapper_bare_metal_thread_function(void *arg)
             earliest_start_time_us + actual_read_time_us + compute_time_us + (write_end_timestamp_us - write_start_timestamp_us),
             write_payload_bytes);
 
-        common_comm_name_to_w_time_offset_payload_create(common, succ->get_name(), write_of_range_payload);
+        common_comm_id_to_w_time_offset_payload_create(common, comm_id, write_of_range_payload);
 
-        common_writes_active_increment(common, succ->get_name());
+        common_writes_active_increment(common, comm_id);
 
-        XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => write: %s, payload (bytes): %f, numa_locality_after_write: [%s].",
-            thread_pid, thread_tid, exec->get_cname(), thread_core_id, succ->get_cname(), write_payload_bytes,  common_join(nlaw).c_str());
+        XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => write: %s, payload (bytes): %f, pattern: %s, numa_locality_after_write: [%s].",
+            thread_pid, thread_tid, exec_name, thread_core_id, comm_name, write_payload_bytes,
+            kernels_write_pattern_type_to_str(common->mapper_write_pattern_type).c_str(), common_join(nlaw).c_str());
     }
 
+    hardware_perf_counters_record(common, exec_id, COMMON_PHASE_WRITE, perf_counter_values);
+
     // Save read + compute + write offsets
     double actual_finish_time_us = earliest_start_time_us + actual_read_time_us + compute_time_us + actual_write_time_us;
     time_range_payload_t rcw_of_range_payload = time_range_payload_t(earliest_start_time_us, actual_finish_time_us, flops);
-    common_exec_name_to_rcw_time_offset_payload_create(common, exec->get_name(), rcw_of_range_payload);
+    common_exec_id_to_rcw_time_offset_payload_create(common, exec_id, rcw_of_range_payload);
 
     // Save thread locality.
     thread_locality_t thread_locality = hardware_hwloc_thread_get_locality_from_os(common);
-    common_exec_name_to_thread_locality_create(common, exec->get_name(), thread_locality);
+    common_exec_id_to_thread_locality_create(common, exec_id, thread_locality);
 
     /* CLEAN UP */
 
-    // Mark successors as completed.
-    for (const auto &succ_ptr : exec->get_successors())
-        (succ_ptr.get())->complete(simgrid::s4u::Activity::State::FINISHED);
+    // Mark successors as completed (binary dags have no simgrid activities).
+    if (data->exec)
+        for (const auto &succ_ptr : data->exec->get_successors())
+            (succ_ptr.get())->complete(simgrid::s4u::Activity::State::FINISHED);
+
+    // Release successors whose dependencies are all solved.
+    common_exec_id_set_completed(common, exec_id);
 
     // In the previous version, this worked, but in the current version, exec is a null pointer.
     // As a result, the task itself is not marked as completed, but it was assigned,
     // and its dependencies were marked as completed.
     // data->exec->complete(simgrid::s4u::Activity::State::FINISHED);
 
-    // Decrement the active thread counter and signal if no more threads
-    common_threads_active_decrement(common);
-
     // Mark the selected hwloc_core_id as available.
     common_core_id_set_avail(common, assigned_core_id, true);
 
     // Update core availability
     common_core_id_set_avail_until(common, assigned_core_id, actual_finish_time_us);
 
-    XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => message: finished.", thread_pid, thread_tid, exec->get_cname(), thread_core_id);
+    XBT_INFO("Process ID: %d, Thread ID: %d, Task ID: %s, Core ID: %d => message: finished.", thread_pid, thread_tid, exec_name, thread_core_id);
 
-    // this pointer was created in the thread caller 'assign_exec'
-    free(data);
+    // Decrement the active thread counter and signal the mapper (completion event).
+    // Done last, so the scheduler sees the released successors and core once woken up.
+    common_threads_active_decrement(common);
 
     return NULL;
 }
@@ -1,13 +1,23 @@
 #include "mapper_base.hpp"
 
-Mapper_Base::Mapper_Base(common_t *common, scheduler_t &scheduler) : common(common), scheduler(scheduler)
+Mapper_Base::Mapper_Base(common_t *common, scheduler_t &scheduler, simgrid_execs_t &dag)
+    : common(common), dummy_host(nullptr), dummy_net_zone(nullptr), scheduler(scheduler), dag(dag)
 {
+    // Binary and WfCommons dags have no simgrid activities, so no simgrid (process-wide) state is
+    // created, and mappers can run in parallel (sweep).
+    if (!this->has_simgrid_execs()) return;
+
     /* CREATE DUMMY HOST (CORE) */
     this->dummy_net_zone = simgrid::s4u::create_full_zone("zone0");
     this->dummy_host = dummy_net_zone->create_host("host0", "1Gf")->seal();
     this->dummy_net_zone->seal();
 }
 
+bool Mapper_Base::has_simgrid_execs() const
+{
+    return !this->dag.empty() && this->dag.front() != nullptr;
+}
+
 void Mapper_Base::set_thread_func_ptr(void *(*func)(void *))
 {
     this->thread_func_ptr = func;
@@ -2,7 +2,8 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(mapper_simulation, "Messages specific to this module.");
 
-Mapper_Simulation::Mapper_Simulation(common_t *common, scheduler_t &scheduler) : Mapper_Base(common, scheduler)
+Mapper_Simulation::Mapper_Simulation(common_t *common, scheduler_t &scheduler, simgrid_execs_t &dag)
+    : Mapper_Base(common, scheduler, dag), events_seq(0)
 {
     this->set_thread_func_ptr(mapper_simulation_thread_function);
 }
@@ -13,53 +14,159 @@ Mapper_Simulation::~Mapper_Simulation()
 
 void Mapper_Simulation::start()
 {
-    XBT_INFO("Start mapper_simulation");
-    simgrid_exec_t *selected_exec;
-    int selected_core_id;
-    double estimated_completion_time;
+    XBT_INFO("Start mapper_simulation (engine: %s)", common_simulation_engine_type_to_str(this->common->mapper_simulation_engine).c_str());
 
     // Mandatory previous to initiate any scheduling activity.
     this->scheduler.initialize();
 
+    if (this->common->mapper_simulation_engine == COMMON_SIMULATION_ENGINE_EVENT)
+        this->start_event();
+    else
+        this->start_list();
+
+    // Workaround to properly finalize SimGrid resources.
+    if (this->has_simgrid_execs())
+    {
+        simgrid::s4u::Engine *e = simgrid::s4u::Engine::get_instance();
+        e->run();
+    }
+
+    XBT_INFO("End mapper_simulation");
+}
+
+/**
+ * @brief Run exec_id on core_id to completion; its read, compute and write offsets are set on return.
+ */
+void Mapper_Simulation::dispatch(int exec_id, int core_id)
+{
+    // Initialize thread data.
+    // data is free'd by the thread at the end of the execution.
+    thread_data_t *data = (thread_data_t *)malloc(sizeof(thread_data_t));
+    data->exec_id = exec_id;
+    data->exec = this->dag[exec_id];
+    data->assigned_core_id = core_id;
+    data->common = this->common;
+    data->thread_function = nullptr;
+
+    // Set as assigned.
+    if (data->exec) data->exec->set_host(this->dummy_host);
+    common_exec_id_to_core_id_create(this->common, exec_id, core_id);
+
+    // Task execution must be performed first to ensure that earliest_start_time
+    // is calculated correctly. Then, core availability must be set.
+    this->thread_func_ptr(data);
+}
+
+/**
+ * @brief List engine: execs run to completion in the order next() returns them.
+ */
+void Mapper_Simulation::start_list()
+{
+    int selected_exec_id;
+    int selected_core_id;
+    double estimated_completion_time;
+
     while (this->scheduler.has_next())
     {
-        std::tie(selected_exec, selected_core_id, estimated_completion_time) = this->scheduler.next();
+        common_scheduler_decision_begin(this->common);
+        std::tie(selected_exec_id, selected_core_id, estimated_completion_time) = this->scheduler.next();
+        common_scheduler_decision_end(this->common);
 
-        if (!selected_exec)
+        // Execs run to completion inside the mapper loop, so no completion can arrive while waiting.
+        if (selected_exec_id == -1)
         {
-            XBT_INFO("There are not ready tasks, waiting 5 seconds.");
-            sleep(5);
-            continue;
+            XBT_ERROR("There are not ready tasks and no task is running.");
+            throw std::runtime_error("There are not ready tasks and no task is running.");
         }
 
         if (selected_core_id == -1)
         {
-            XBT_INFO("There are not available cores, waiting 5 seconds.");
-            sleep(5);
-            continue;
+            XBT_ERROR("There are not available cores and no task is running.");
+            throw std::runtime_error("There are not available cores and no task is running.");
         }
 
-        // Initialize thread data.
-        // data is free'd by the thread at the end of the execution.
-        thread_data_t *data = (thread_data_t *)malloc(sizeof(thread_data_t));
-        data->exec = selected_exec;
-        data->assigned_core_id = selected_core_id;
-        data->common = this->common;
-        data->thread_function = nullptr;
+        this->dispatch(selected_exec_id, selected_core_id);
+    }
+}
 
-        // Set as assigned.
-        selected_exec->set_host(this->dummy_host);
+void Mapper_Simulation::event_push(double time_us, mapper_simulation_event_type_t type, unsigned int id)
+{
+    this->events.push(mapper_simulation_event_t{time_us, this->events_seq++, type, id});
+}
 
-        // Task execution must be performed first to ensure that earliest_start_time  
-        // is calculated correctly. Then, core availability must be set. 
-        this->thread_func_ptr(data);
+/**
+ * @brief Pop and apply every event up to time_us (inclusive), in (time, insertion) order.
+ */
+void Mapper_Simulation::events_process_until(double time_us)
+{
+    while (!this->events.empty() && this->events.top().time_us <= time_us)
+    {
+        mapper_simulation_event_t event = this->events.top();
+        this->events.pop();
+
+        switch (event.type) {
+            case MAPPER_SIMULATION_EVENT_EXEC_FINISH:
+                XBT_DEBUG("Event time (us): %f => exec finish, core_id: %u", event.time_us, event.id);
+                common_core_id_set_avail(this->common, event.id, true);
+                break;
+            case MAPPER_SIMULATION_EVENT_DATA_READY:
+                XBT_DEBUG("Event time (us): %f => data ready: %s", event.time_us, this->common->workflow.comm_names[event.id].c_str());
+                common_comm_id_set_ready(this->common, event.id);
+                break;
+        }
     }
+}
 
-    // Workaround to properly finalize SimGrid resources.
-    simgrid::s4u::Engine *e = simgrid::s4u::Engine::get_instance();
-    e->run();
+/**
+ * @brief Event engine: a discrete-event simulation driven by a time-ordered event heap.
+ *
+ * At the current time (simulation_clock_us), the events due are applied and next() is invoked
+ * until it cannot dispatch; then the clock jumps to the next event. A dispatched exec keeps its
+ * core unavailable until its exec finish event, and its successors are released by the data
+ * ready events of its comms. Each event costs O(log n) on the heap.
+ */
+void Mapper_Simulation::start_event()
+{
+    int selected_exec_id;
+    int selected_core_id;
+    double estimated_completion_time;
 
-    XBT_INFO("End mapper_simulation");
+    this->common->simulation_clock_us = 0.0;
+
+    while (this->scheduler.has_next())
+    {
+        this->events_process_until(this->common->simulation_clock_us);
+
+        common_scheduler_decision_begin(this->common);
+        std::tie(selected_exec_id, selected_core_id, estimated_completion_time) = this->scheduler.next();
+        common_scheduler_decision_end(this->common);
+
+        if (selected_exec_id == -1 || selected_core_id == -1)
+        {
+            if (this->events.empty())
+            {
+                XBT_ERROR("There are not ready tasks or available cores and no task is running.");
+                throw std::runtime_error("There are not ready tasks or available cores and no task is running.");
+            }
+
+            // Nothing can be dispatched until the next event.
+            this->common->simulation_clock_us = this->events.top().time_us;
+            continue;
+        }
+
+        common_core_id_set_avail(this->common, selected_core_id, false);
+        this->dispatch(selected_exec_id, selected_core_id);
+
+        // Successors read after the exec finishes (common_earliest_start_time), so its comms are ready then.
+        double finish_time_us = this->common->core_avail_until[selected_core_id];
+        this->event_push(finish_time_us, MAPPER_SIMULATION_EVENT_EXEC_FINISH, selected_core_id);
+
+        for (unsigned int comm_id : common_exec_id_get_out_comm_ids(this->common, selected_exec_id))
+            this->event_push(finish_time_us, MAPPER_SIMULATION_EVENT_DATA_READY, comm_id);
+    }
+
+    // The cores still busy become available once their execs finish.
+    this->events_process_until(std::numeric_limits<double>::infinity());
 }
 
 /**
@@ -87,85 +194,102 @@ void *mapper_simulation_thread_function(void *arg)
     thread_data_t* data = ((thread_data_t *) arg);
 
     common_t *common = data->common;
-    simgrid_exec_t *exec = data->exec;
+    const workflow_t &workflow = common->workflow;
+    unsigned int exec_id = data->exec_id;
+    const char *exec_name = workflow.exec_names[exec_id].c_str();
     int assigned_core_id = data->assigned_core_id;
     int assigned_core_numa_id = hardware_hwloc_numa_id_get_by_core_id(common, assigned_core_id);
 
-    XBT_INFO("Task ID: %s, Core ID: %d => message: started.", exec->get_cname(), assigned_core_id);
+    XBT_INFO("Task ID: %s, Core ID: %d => message: started.", exec_name, assigned_core_id);
+
+    double earliest_start_time_us = common_earliest_start_time(common, exec_id, assigned_core_id);
 
-    double earliest_start_time_us = common_earliest_start_time(common, exec->get_name(), assigned_core_id);
+    // With mapper_charge_decision_time, the exec starts once the decision that scheduled it ends.
+    if (common->scheduler_stats.charge_decision_time)
+        earliest_start_time_us = std::max(earliest_start_time_us, common->scheduler_stats.decision_clock_us);
 
     /* SIMULATE MEMORY READING */
 
     double read_start_timestamp_us = earliest_start_time_us;
     double max_read_end_timestamp_us = 0.0;
     
-    // Match all communication (Task1->Task2) where this task_name is the destination.
-    name_to_time_range_payload_t matches = common_comm_name_to_w_time_offset_payload_filter(common, exec->get_name());
-
-    for (const auto &[comm_name, time_range_payload] : matches)
+    // All communications (Task1->Task2) where this task is the destination.
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(common, exec_id))
     {
-        double read_payload_bytes = std::get<2>(time_range_payload);
+        double read_payload_bytes = std::get<2>(common_comm_id_to_w_time_offset_payload_get(common, comm_id));
 
         // ASSUMPTION:
         // The simulation assumes that the entire data item is stored in a single memory domain.
         // Future implementations may consider data pages being spread, NUMA balancing (page migration).
         // Future implmenetations may also consider reproduce a data access pattern collected from a real execution.
 
-        int read_src_numa_id = common_comm_name_to_numa_ids_w_get(common, comm_name).front();      
+        int read_src_numa_id = common_numa_mask_first(common_comm_id_to_numa_ids_w_get(common, comm_id));
 
-        double read_time_us = common_communication_time(common, read_src_numa_id, assigned_core_numa_id, read_payload_bytes);
+        // With mapper_prefetch, the data item may be migrated to the NUMA node of the core before the read.
+        double migration_time_us;
+        double read_time_us = common_comm_id_read_time(common, comm_id, assigned_core_numa_id, earliest_start_time_us, &migration_time_us);
 
         double read_end_timestamp_us = read_start_timestamp_us + read_time_us;
 
         max_read_end_timestamp_us = std::max(max_read_end_timestamp_us, read_end_timestamp_us);
 
+        if (migration_time_us > 0.0)
+        {
+            // The migration starts as soon as the data item is written; the part not overlapped
+            // before earliest_start_time_us delays the (local) read.
+            double write_end_timestamp_us = std::get<1>(common_comm_id_to_w_time_offset_payload_get(common, comm_id));
+
+            time_range_payload_t migration_of_payload = time_range_payload_t(
+                write_end_timestamp_us, write_end_timestamp_us + migration_time_us, read_payload_bytes);
+            common_comm_id_to_m_time_offset_payload_create(common, comm_id, migration_of_payload);
+
+            XBT_INFO("Task ID: %s, Core ID: %d => migration: %s, src_numa_id: %d, dst_numa_id: %d",
+                exec_name, assigned_core_id, workflow.comm_names[comm_id].c_str(), read_src_numa_id, assigned_core_numa_id);
+
+            read_src_numa_id = assigned_core_numa_id;
+        }
+
         // Save read data locality.
-        common_comm_name_to_numa_ids_r_create(common, comm_name, {read_src_numa_id});
+        common_comm_id_to_numa_ids_r_create(common, comm_id, {read_src_numa_id});
 
         // Save read time offset.
         time_range_payload_t read_of_payload = time_range_payload_t(read_start_timestamp_us, read_end_timestamp_us, read_payload_bytes);
-        common_comm_name_to_r_time_offset_payload_create(common, comm_name, read_of_payload);
+        common_comm_id_to_r_time_offset_payload_create(common, comm_id, read_of_payload);
 
-        XBT_INFO("Task ID: %s, Core ID: %d => read: %s, payload (bytes): %f", exec->get_cname(), assigned_core_id, comm_name.c_str(), read_payload_bytes);
+        XBT_INFO("Task ID: %s, Core ID: %d => read: %s, payload (bytes): %f", exec_name, assigned_core_id, workflow.comm_names[comm_id].c_str(), read_payload_bytes);
 
-        common_reads_active_increment(common, comm_name);
+        common_reads_active_increment(common, comm_id);
     }
 
     /* SIMULATE COMPUTATION */
 
     double exec_start_timestamp_us = std::max(earliest_start_time_us, max_read_end_timestamp_us);
 
-    double flops = exec->get_remaining();
+    double flops = workflow.exec_flops[exec_id];
     double clock_frequency_hz = hardware_hwloc_core_id_get_clock_frequency(common, assigned_core_id);
-    double compute_time_us = common_compute_time(common, flops, clock_frequency_hz);
+    double compute_time_us = common_compute_time(common, assigned_core_id, flops, clock_frequency_hz);
     
     double exec_end_timestamp_us = exec_start_timestamp_us + compute_time_us;
 
     // Save compute offsets.
     time_range_payload_t exec_of_range_payload = time_range_payload_t{exec_start_timestamp_us, exec_end_timestamp_us, flops};
 
-    common_exec_name_to_c_time_offset_payload_create(common, exec->get_name(), exec_of_range_payload);
+    common_exec_id_to_c_time_offset_payload_create(common, exec_id, exec_of_range_payload);
 
-    common_execs_active_increment(common, exec->get_name());
+    common_execs_active_increment(common, exec_id);
 
     /* SIMULATE MEMORY WRITTING */
 
     double write_start_timestamp_us = exec_end_timestamp_us;
     double max_end_write_timestamp_us = 0.0;
 
-    for (const auto &succ_ptr : exec->get_successors())
+    // task_i->end communications are not part of the workflow comms.
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(common, exec_id))
     {
-        const simgrid_activity_t *succ = succ_ptr.get();
-        auto [exec_name, succ_exec_name] = common_split(succ->get_name());
-
-        // Skipt all task_i->end communications.
-        if (succ_exec_name == std::string("end")) continue;
-
         // ASSUMPTION:
         // Writes will follow the first-touch policy, i.e., data will be saved in 
         // the numa node that share locality with the core_id.
-        double write_payload_bytes = succ->get_remaining();
+        double write_payload_bytes = workflow.comm_payloads[comm_id];
         double write_time_us = common_communication_time(common, assigned_core_numa_id, assigned_core_numa_id, write_payload_bytes);
 
         // Compute write time, assuming reads are carried out in parallel.
@@ -174,35 +298,40 @@ void *mapper_simulation_thread_function(void *arg)
         max_end_write_timestamp_us = std::max(max_end_write_timestamp_us, write_end_timestamp_us);
 
         // Save address for subsequent reading.
-        common_comm_name_to_address_create(common, succ->get_name(), nullptr);
+        common_comm_id_to_address_create(common, comm_id, nullptr);
 
         // Save data locality.
-        common_comm_name_to_numa_ids_w_create(common, succ->get_name(), {assigned_core_numa_id});
+        common_comm_id_to_numa_ids_w_create(common, comm_id, {assigned_core_numa_id});
 
         // Save write offsets.
         time_range_payload_t write_of_range_payload = time_range_payload_t(write_start_timestamp_us, write_end_timestamp_us, write_payload_bytes);
 
-        common_comm_name_to_w_time_offset_payload_create(common, succ->get_name(), write_of_range_payload);
+        common_comm_id_to_w_time_offset_payload_create(common, comm_id, write_of_range_payload);
 
-        common_writes_active_increment(common, succ->get_name());
+        common_writes_active_increment(common, comm_id);
 
-        XBT_INFO("Task ID: %s, Core ID: %d => write: %s, payload (bytes): %f.", exec->get_cname(), assigned_core_id, succ->get_cname(), write_payload_bytes);
+        XBT_INFO("Task ID: %s, Core ID: %d => write: %s, payload (bytes): %f.", exec_name, assigned_core_id, workflow.comm_names[comm_id].c_str(), write_payload_bytes);
     }
 
     // Save read + compute + write offsets
     double actual_finish_time_us = std::max(exec_end_timestamp_us, max_end_write_timestamp_us);
     time_range_payload_t rcw_of_range_payload = time_range_payload_t(read_start_timestamp_us, actual_finish_time_us, flops);
-    common_exec_name_to_rcw_time_offset_payload_create(common, exec->get_name(), rcw_of_range_payload);
+    common_exec_id_to_rcw_time_offset_payload_create(common, exec_id, rcw_of_range_payload);
 
     // Save thread locality.
     thread_locality_t thread_locality = {assigned_core_numa_id, assigned_core_id, 0, 0, 0};
-    common_exec_name_to_thread_locality_create(common, exec->get_name(), thread_locality);
+    common_exec_id_to_thread_locality_create(common, exec_id, thread_locality);
 
     /* CLEAN UP */
 
-    // Mark successors as completed.
-    for (const auto &succ_ptr : data->exec->get_successors())
-        (succ_ptr.get())->complete(simgrid::s4u::Activity::State::FINISHED);
+    // Mark successors as completed (binary dags have no simgrid activities).
+    if (data->exec)
+        for (const auto &succ_ptr : data->exec->get_successors())
+            (succ_ptr.get())->complete(simgrid::s4u::Activity::State::FINISHED);
+
+    // Release successors whose dependencies are all solved (the event engine releases them at data ready events).
+    if (common->mapper_simulation_engine == COMMON_SIMULATION_ENGINE_LIST)
+        common_exec_id_set_completed(common, exec_id);
 
     // Mark the selected hwloc_core_id as available.
     // common_core_id_set_avail(common, assigned_core_id, true);
@@ -210,7 +339,7 @@ void *mapper_simulation_thread_function(void *arg)
     // Update core availability
     common_core_id_set_avail_until(common, assigned_core_id, actual_finish_time_us);
 
-    XBT_INFO("Task ID: %s, Core ID: %d => message: finished.", exec->get_cname(), assigned_core_id);
+    XBT_INFO("Task ID: %s, Core ID: %d => message: finished.", exec_name, assigned_core_id);
 
     // this pointer was created in the thread caller 'assign_exec'
     free(data);
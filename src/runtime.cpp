@@ -11,53 +11,147 @@ void runtime_start(mapper_t **mapper)
 void runtime_stop(common_t **common)
 {
     XBT_INFO("End runtime.");
+    common_trace_finalize(*common);
+    common_timeline_finalize(*common);
     common_print_common_structure(*common, 0);
 }
 
+static void runtime_configure(common_t **common, simgrid_execs_t **dag, scheduler_t **scheduler, mapper_t **mapper, nlohmann::json &data);
+
+static void runtime_topology_load(common_t *common)
+{
+    if (hwloc_topology_init(&(common->topology)) != 0)
+        throw std::runtime_error("Failed to initialize topology.");
+
+    if (hwloc_topology_load(common->topology) != 0)
+        throw std::runtime_error("Failed to load topology.");
+
+    hardware_hwloc_topology_tables_initialize(common);
+}
+
+/**
+ * @brief nflows --calibrate: measure the NUMA distance matrices of this machine and write them
+ * in the distance_matrices file format.
+ */
+void runtime_calibrate(common_t **common, const std::string &latency_file, const std::string &bandwidth_file, size_t buffer_mib)
+{
+    XBT_INFO("Calibrate NUMA distances (buffer: %zu MiB).", buffer_mib);
+    *common = new common_t();
+
+    runtime_topology_load(*common);
+
+    hardware_numa_distances_calibrate(*common, buffer_mib << 20, (*common)->distance_lat_ns, (*common)->distance_bw_gbps);
+
+    common_distance_matrix_write_to_txt((*common)->distance_lat_ns, latency_file);
+    common_distance_matrix_write_to_txt((*common)->distance_bw_gbps, bandwidth_file);
+
+    XBT_INFO("Distance matrices: %s, %s", latency_file.c_str(), bandwidth_file.c_str());
+}
+
+/**
+ * @brief nflows --convert-dag: write a DOT dag as a binary dag file (dag.hpp).
+ */
+void runtime_convert_dag(common_t **common, simgrid_execs_t **dag, const std::string &dot_file, const std::string &dag_file)
+{
+    XBT_INFO("Convert dag: %s -> %s", dot_file.c_str(), dag_file.c_str());
+
+    if (!dag_file_is_binary(dag_file))
+    {
+        XBT_ERROR("The binary dag file name must end with '%s'.", DAG_FILE_EXTENSION);
+        throw std::runtime_error("The binary dag file name must end with '" DAG_FILE_EXTENSION "'.");
+    }
+
+    *dag = new simgrid_execs_t(common_dag_read_from_dot(dot_file));
+    *common = new common_t();
+
+    common_workflow_initialize(*common, **dag);
+    common_workflow_write_to_dag_file(*common, dag_file);
+}
+
+/**
+ * @brief Read dag_file into the workflow tables of common; the format is selected by the extension.
+ */
+static void runtime_dag_load(common_t *common, simgrid_execs_t **dag, nlohmann::json &data)
+{
+    // Binary and WfCommons dags have no simgrid activities: the dag holds one null exec per exec_id.
+    std::string dag_file_name = data["dag_file"];
+    bool dag_file_wfcommons = dag_file_name.size() >= 5 && dag_file_name.compare(dag_file_name.size() - 5, 5, ".json") == 0;
+
+    // Dense exec/comm ids and id-indexed tables.
+    if (dag_file_is_binary(dag_file_name)) {
+        dag_file_t dag_file = {};
+        dag_open(dag_file, dag_file_name);
+        common_workflow_initialize_from_dag_file(common, dag_file);
+        dag_close(dag_file);
+        *dag = new simgrid_execs_t(common->workflow.exec_names.size(), nullptr);
+    } else if (dag_file_wfcommons) {
+        // Task runtimes are converted with the core speed of the platform unless given.
+        double core_flops_per_second = data.value("wfcommons_core_flops_per_second",
+            data.value("flops_per_cycle", 0.0) * data.value("clock_frequency_hz", 0.0));
+
+        if (!(core_flops_per_second > 0.0))
+        {
+            XBT_ERROR("WfCommons dag_file requires wfcommons_core_flops_per_second (or a static clock_frequency_hz).");
+            throw std::runtime_error("Missing wfcommons_core_flops_per_second.");
+        }
+
+        common_workflow_initialize_from_wfcommons(common, dag_file_name, core_flops_per_second);
+        *dag = new simgrid_execs_t(common->workflow.exec_names.size(), nullptr);
+    } else {
+        *dag = new simgrid_execs_t(common_dag_read_from_dot(dag_file_name));
+        common_workflow_initialize(common, **dag);
+    }
+}
+
 void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **scheduler, mapper_t **mapper, const std::string &config_path)
 {
     XBT_INFO("Initialize runtime.");
     nlohmann::json data = common_config_file_read(config_path);
-    simgrid_execs_t execs = common_dag_read_from_dot(data["dag_file"]);
 
-    *dag = new simgrid_execs_t(execs);
     *common = new common_t();
 
-    // Runtime system status.
-    if (hwloc_topology_init(&((*common)->topology)) != 0)
-        throw std::runtime_error("Failed to initialize topology.");
-
-    if (hwloc_topology_load((*common)->topology) != 0)
-        throw std::runtime_error("Failed to load topology.");
+    runtime_topology_load(*common);
+    runtime_dag_load(*common, dag, data);
+    runtime_configure(common, dag, scheduler, mapper, data);
+}
 
+/**
+ * @brief Set up common, the scheduler and the mapper from a config, once the topology and the workflow are loaded.
+ */
+static void runtime_configure(common_t **common, simgrid_execs_t **dag, scheduler_t **scheduler, mapper_t **mapper, nlohmann::json &data)
+{
+    // Runtime system status.
     (*common)->threads_active = 0;
     (*common)->threads_checksum = 0;
+    (*common)->threads_completed = 0;
+    (*common)->threads_failed = 0;
 
     (*common)->threads_cond = PTHREAD_COND_INITIALIZER;
     (*common)->threads_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-    // Counters
-    for (const simgrid_exec_t *exec :(**dag))
-    {
-        (*common)->execs_active[exec->get_name()] = 0;
-
-        for (const auto &succ_ptr : exec->get_dependencies())
-            (*common)->reads_active[(succ_ptr.get())->get_name()] = 0;
-
-        for (const auto &succ_ptr : exec->get_successors())
-            // Skipt all task_i->end communications.
-            if (common_split((succ_ptr.get())->get_cname(), "->").second != std::string("end"))
-                (*common)->writes_active[(succ_ptr.get())->get_name()] = 0;
-    }
-
     // User-defined.
     (*common)->flops_per_cycle = data["flops_per_cycle"];
+    (*common)->flops_per_cycle_calibration_ms = data.value("flops_per_cycle_calibration_ms", 0u);
     (*common)->clock_frequency_type = common_clock_frequency_str_to_type(data["clock_frequency_type"]);
 
     switch ((*common)->clock_frequency_type) {
         case COMMON_DYNAMIC_CLOCK_FREQUENCY:
+        {
             (*common)->clock_frequency_hz = 0;
+
+            // Optional sampler settings (sampler interval 0 reads sysfs on every query).
+            clock_frequency_sampler_t &sampler = (*common)->clock_frequency_sampler;
+            sampler.sysfs_root = data.value("clock_frequency_sysfs_root", std::string("/sys/devices/system/cpu"));
+            sampler.interval_ms = data.value("clock_frequency_sampler_interval_ms", 100u);
+            sampler.ewma_alpha = data.value("clock_frequency_sampler_ewma_alpha", 1.0);
+
+            if (!(sampler.ewma_alpha > 0.0 && sampler.ewma_alpha <= 1.0))
+            {
+                XBT_ERROR("Invalid clock_frequency_sampler_ewma_alpha: %f (expected 0 < alpha <= 1).", sampler.ewma_alpha);
+                throw std::runtime_error("Invalid clock_frequency_sampler_ewma_alpha.");
+            }
             break;
+        }
             
         case COMMON_STATIC_CLOCK_FREQUENCY:
             (*common)->clock_frequency_hz = data["clock_frequency_hz"];
@@ -81,8 +175,31 @@ void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **
         (*common)->out_file_name = data["out_file_name"];
     }
 
-    (*common)->distance_lat_ns = common_distance_matrix_read_from_txt(data["distance_matrices"]["latency_ns"]);
-    (*common)->distance_bw_gbps = common_distance_matrix_read_from_txt(data["distance_matrices"]["bandwidth_gbps"]);
+    // Distance matrices without a file fall back to the hwloc NUMA distances (ACPI SLIT).
+    nlohmann::json distance_matrices = data.value("distance_matrices", nlohmann::json::object());
+    std::string latency_file = distance_matrices.value("latency_ns", "");
+    std::string bandwidth_file = distance_matrices.value("bandwidth_gbps", "");
+
+    if (latency_file.empty() || bandwidth_file.empty())
+    {
+        distance_matrix_t slit_lat_ns, slit_bw_gbps;
+        if (!hardware_hwloc_distance_matrices_from_slit(*common,
+                distance_matrices.value("slit_local_latency_ns", 100.0), distance_matrices.value("slit_local_bandwidth_gbps", 10.0),
+                slit_lat_ns, slit_bw_gbps))
+        {
+            XBT_ERROR("No distance matrix file given and hwloc reports no NUMA distances; run nflows --calibrate.");
+            throw std::runtime_error("No distance matrices available.");
+        }
+
+        XBT_INFO("Distance matrices: hwloc NUMA distances (SLIT) for %s.",
+            latency_file.empty() && bandwidth_file.empty() ? "latency_ns and bandwidth_gbps" : (latency_file.empty() ? "latency_ns" : "bandwidth_gbps"));
+
+        (*common)->distance_lat_ns = slit_lat_ns;
+        (*common)->distance_bw_gbps = slit_bw_gbps;
+    }
+
+    if (!latency_file.empty()) (*common)->distance_lat_ns = common_distance_matrix_read_from_txt(latency_file);
+    if (!bandwidth_file.empty()) (*common)->distance_bw_gbps = common_distance_matrix_read_from_txt(bandwidth_file);
 
     std::string core_avail_mask = data["core_avail_mask"].get<std::string>();
     if (!core_avail_mask.empty()) {
@@ -95,6 +212,10 @@ void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **
         (*common)->core_avail_until.resize(((*common)->core_avail).size(), 0.0);
     }
 
+    // Sampled cores are the available ones (core_avail must be set).
+    if ((*common)->clock_frequency_type == COMMON_DYNAMIC_CLOCK_FREQUENCY)
+        hardware_clock_frequency_sampler_start(*common);
+
     *scheduler = nullptr;
     const std::string scheduler_type = data["scheduler_type"];
     switch (common_scheduler_str_to_type(scheduler_type)) {
@@ -117,8 +238,98 @@ void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **
         }
     }
 
+    // NUMA memory budgets; the capacity (hwloc local_memory) may be overridden, e.g., to simulate other systems.
+    size_t numa_count = (*common)->distance_lat_ns.size();
+
+    if (data.contains("numa_memory_capacity_bytes"))
+    {
+        (*common)->numa_id_to_capacity_bytes = data["numa_memory_capacity_bytes"].get<std::vector<double>>();
+
+        if ((*common)->numa_id_to_capacity_bytes.size() != numa_count)
+        {
+            XBT_ERROR("numa_memory_capacity_bytes has %zu entries, expected %zu (numa nodes in the distance matrices).",
+                (*common)->numa_id_to_capacity_bytes.size(), numa_count);
+            throw std::runtime_error("numa_memory_capacity_bytes does not match the distance matrices.");
+        }
+    } else {
+        // Nodes missing from the topology (e.g., simulating a larger system) have an unknown capacity.
+        (*common)->numa_id_to_capacity_bytes = (*common)->topology_tables.numa_id_to_local_memory_bytes;
+        (*common)->numa_id_to_capacity_bytes.resize(numa_count, 0.0);
+    }
+
+    (*common)->numa_memory_budget_ratio = data.value("numa_memory_budget_ratio", 1.0);
+    (*common)->numa_memory_policy = common_numa_memory_policy_str_to_type(common_scheduler_param_get(*common, "numa_memory_policy"));
+
+    std::string numa_memory_high_watermark = common_scheduler_param_get(*common, "numa_memory_high_watermark");
+    (*common)->numa_memory_high_watermark = numa_memory_high_watermark.empty() ? 0.0 : std::stod(numa_memory_high_watermark);
+
+    common_numa_memory_initialize(*common);
+
     (*common)->mapper_mem_policy_type = common_mapper_mem_policy_str_to_type(data["mapper_mem_policy_type"]);
     (*common)->mapper_mem_bind_numa_node_ids = data["mapper_mem_bind_numa_node_ids"].get<std::vector<unsigned>>();
+    (*common)->mapper_thread_pool = data.value("mapper_thread_pool", false);
+
+    // NUMA arena for the data items (bare-metal); placement overrides the thread memory policy.
+    (*common)->mapper_mem_arena.enabled = data.value("mapper_mem_arena", false);
+    (*common)->mapper_mem_arena.huge_pages_type = common_huge_pages_str_to_type(data.value("mapper_mem_arena_huge_pages", "none"));
+    hardware_numa_arena_initialize(*common);
+
+    // Per-exec performance counters; the source is probed once (hardware, software or rusage).
+    (*common)->mapper_perf_counters = data.value("mapper_perf_counters", false);
+    hardware_perf_counters_initialize(*common);
+
+    // Trace backend; by default the binary trace is written next to the output file (extension .trace).
+    std::string trace_file_name = (*common)->out_file_name;
+    size_t trace_extension_pos = trace_file_name.find_last_of("./");
+    if (trace_extension_pos != std::string::npos && trace_file_name[trace_extension_pos] == '.' && trace_extension_pos > 0)
+        trace_file_name.resize(trace_extension_pos);
+
+    trace_file_name = data.value("trace_file_name", trace_file_name + ".trace");
+    common_trace_initialize(*common, trace_backend_str_to_type(data.value("trace_backend", "yaml")), trace_file_name);
+
+    // Chrome Trace Event (Perfetto) timeline of the read, compute and write phases by core; disabled if empty.
+    common_timeline_initialize(*common, data.value("timeline_file_name", ""));
+
+    // Charge the measured scheduling decision time to the simulated clock (simulation mapper).
+    (*common)->scheduler_stats.charge_decision_time = data.value("mapper_charge_decision_time", false);
+
+    // Migrate task inputs to the NUMA node of the assigned core when cheaper than remote reads.
+    (*common)->mapper_prefetch = data.value("mapper_prefetch", false);
+
+    // Time model of the simulation mapper: list scheduling (default) or discrete events.
+    (*common)->mapper_simulation_engine = common_simulation_engine_str_to_type(data.value("mapper_simulation_engine", "list"));
+
+    // Emulation kernels; the ISA is detected with CPUID unless forced.
+    kernels_isa_t kernels_isa_detected = kernels_isa_detect();
+    const std::string mapper_kernels_isa = data.value("mapper_kernels_isa", "auto");
+    (*common)->mapper_kernels_isa = (mapper_kernels_isa == "auto") ? kernels_isa_detected : kernels_isa_str_to_type(mapper_kernels_isa);
+
+    if ((*common)->mapper_kernels_isa > kernels_isa_detected)
+    {
+        XBT_ERROR("mapper_kernels_isa '%s' is not supported by this CPU (detected: '%s').",
+            mapper_kernels_isa.c_str(), kernels_isa_type_to_str(kernels_isa_detected).c_str());
+        throw std::runtime_error("mapper_kernels_isa is not supported by this CPU.");
+    }
+
+    (*common)->mapper_read_pattern_type = kernels_read_pattern_str_to_type(data.value("mapper_read_pattern_type", "sequential"));
+    (*common)->mapper_read_stride_bytes = data.value("mapper_read_stride_bytes", (size_t) 4096);
+    (*common)->mapper_write_pattern_type = kernels_write_pattern_str_to_type(data.value("mapper_write_pattern_type", "temporal"));
+    (*common)->mapper_compute_pattern_type = kernels_compute_pattern_str_to_type(data.value("mapper_compute_pattern_type", "fma"));
+
+    if ((*common)->mapper_read_stride_bytes < KERNELS_CACHE_LINE_BYTES)
+    {
+        XBT_ERROR("mapper_read_stride_bytes must be >= %d.", KERNELS_CACHE_LINE_BYTES);
+        throw std::runtime_error("mapper_read_stride_bytes must be >= cache line size.");
+    }
+
+    XBT_INFO("Emulation kernels: isa %s, read %s, write %s, compute %s.",
+        kernels_isa_type_to_str((*common)->mapper_kernels_isa).c_str(),
+        kernels_read_pattern_type_to_str((*common)->mapper_read_pattern_type).c_str(),
+        kernels_write_pattern_type_to_str((*common)->mapper_write_pattern_type).c_str(),
+        kernels_compute_pattern_type_to_str((*common)->mapper_compute_pattern_type).c_str());
+
+    // Needs the available cores, their clock frequencies and the compute kernel.
+    hardware_flops_per_cycle_calibrate(*common);
 
     *mapper = nullptr;
     std::string mapper_type = data["mapper_type"];
@@ -126,10 +337,10 @@ void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **
 
     switch ((*common)->mapper_type) {
         case COMMON_MAPPER_BARE_METAL:
-            *mapper = new mapper_bare_metal_t((*common), (**scheduler)); 
+            *mapper = new mapper_bare_metal_t((*common), (**scheduler), (**dag)); 
             break;
         case COMMON_MAPPER_SIMULATION:
-            *mapper = new mapper_simulation_t((*common), (**scheduler)); break;
+            *mapper = new mapper_simulation_t((*common), (**scheduler), (**dag)); break;
         default:
             XBT_ERROR("Invalid mapper type '%s'", 
                 common_mapper_type_to_str((*common)->mapper_type).c_str());
@@ -138,6 +349,241 @@ void runtime_initialize(common_t **common, simgrid_execs_t **dag, scheduler_t **
     }
 }
 
+struct runtime_sweep_result_s
+{
+    bool completed;
+    double makespan_us;
+    double remote_bytes;
+    double scheduling_time_us;
+    size_t decisions_count;
+};
+typedef struct runtime_sweep_result_s runtime_sweep_result_t;
+
+// Combinations are taken in order by the workers; each one runs with its own common, scheduler and mapper.
+struct runtime_sweep_s
+{
+    const common_t *common;  // Topology and workflow, shared read-only.
+    nlohmann::json base;
+    std::vector<nlohmann::json> combinations;
+    std::vector<runtime_sweep_result_t> results;
+    std::atomic<size_t> next_combination;
+};
+typedef struct runtime_sweep_s runtime_sweep_t;
+
+static void *runtime_sweep_thread_function(void *arg)
+{
+    runtime_sweep_t *sweep = (runtime_sweep_t *) arg;
+
+    for (size_t i = sweep->next_combination++; i < sweep->combinations.size(); i = sweep->next_combination++)
+    {
+        nlohmann::json data = sweep->base;
+        for (const auto &[key, value] : sweep->combinations[i].items())
+            data[key] = value;
+
+        common_t *common = nullptr;
+        simgrid_execs_t *dag = nullptr;
+        scheduler_t *scheduler = nullptr;
+        mapper_t *mapper = nullptr;
+
+        runtime_sweep_result_t &result = sweep->results[i];
+        result = {false, 0.0, 0.0, 0.0, 0};
+
+        try {
+            common = new common_t();
+            common->topology = sweep->common->topology;
+            common->topology_tables = sweep->common->topology_tables;
+            common_workflow_initialize_from_workflow(common, sweep->common->workflow);
+            dag = new simgrid_execs_t(common->workflow.exec_names.size(), nullptr);
+
+            runtime_configure(&common, &dag, &scheduler, &mapper, data);
+            mapper->start();
+
+            const std::vector<double> &next_times_us = common->scheduler_stats.next_times_us;
+            result = {true, common_makespan(common), common_remote_read_bytes(common),
+                std::accumulate(next_times_us.begin(), next_times_us.end(), 0.0), next_times_us.size()};
+        }
+        catch (const std::exception &e) {
+            XBT_ERROR("Sweep combination %zu (%s): %s", i, sweep->combinations[i].dump().c_str(), e.what());
+        }
+
+        // The topology belongs to the sweep.
+        if (common) common->topology = nullptr;
+        runtime_finalize(&common, &dag, &scheduler, &mapper);
+    }
+
+    return NULL;
+}
+
+static std::string runtime_csv_quote(const std::string &str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos) return str;
+
+    std::string quoted = "\"";
+    for (char c : str)
+        quoted += (c == '"') ? std::string("\"\"") : std::string(1, c);
+
+    return quoted + "\"";
+}
+
+/**
+ * @brief nflows --sweep: run every combination of the sweep axes of a config in simulation, in parallel.
+ *
+ * The sweep file is a config with a "sweep" object:
+ *   "sweep": {
+ *       "axes": {"scheduler_type": ["heft", "min-min"], "core_avail_mask": ["0x3", "0xf"], ...},
+ *       "threads": 4,                  // Default: hardware threads.
+ *       "out_file_name": "sweep.csv"   // Default: out_file_name with the .csv extension.
+ *   }
+ * Each axis replaces a config key with each of its values (any JSON value, e.g., scheduler_params lists
+ * or distance_matrices objects). The dag and the topology are loaded once; every combination runs the
+ * simulation mapper with its own state, without trace files or output file, flops_per_cycle calibration,
+ * arena or perf counters; the clock must be static or array. The summary has one row per
+ * combination: the axis values, status, makespan_us, remote_bytes, scheduling_time_us and decisions.
+ */
+void runtime_sweep(common_t **common, simgrid_execs_t **dag, const std::string &sweep_path)
+{
+    XBT_INFO("Initialize sweep.");
+    nlohmann::json data = common_config_file_read(sweep_path);
+
+    if (!data.contains("sweep") || !data["sweep"].contains("axes") || !data["sweep"]["axes"].is_object())
+    {
+        XBT_ERROR("Sweep file '%s' has no sweep.axes object.", sweep_path.c_str());
+        throw std::runtime_error("Sweep file has no sweep.axes object.");
+    }
+
+    nlohmann::json sweep_data = data["sweep"];
+    data.erase("sweep");
+
+    // Fixed for the whole sweep: the shared dag, and the per-run calibration and bare-metal
+    // resources (arena, perf counters), which are forced off below.
+    static const std::vector<std::string> fixed_keys = {"dag_file", "mapper_type", "flops_per_cycle_calibration_ms",
+        "mapper_mem_arena", "mapper_mem_arena_huge_pages", "mapper_perf_counters"};
+
+    const nlohmann::json &axes = sweep_data["axes"];
+    for (const auto &[key, values] : axes.items())
+    {
+        if (std::find(fixed_keys.begin(), fixed_keys.end(), key) != fixed_keys.end() || !values.is_array() || values.empty())
+        {
+            XBT_ERROR("Invalid sweep axis '%s' (dag_file, mapper_type, calibration, arena and perf counter keys are fixed; values must be a non-empty list).", key.c_str());
+            throw std::runtime_error("Invalid sweep axis '" + key + "'.");
+        }
+    }
+
+    // Combinations run concurrently: a sampled clock would differ from one run to the next.
+    bool clock_dynamic = data.value("clock_frequency_type", "") == "dynamic";
+    if (axes.contains("clock_frequency_type"))
+        for (const nlohmann::json &value : axes["clock_frequency_type"])
+            clock_dynamic = clock_dynamic || value == "dynamic";
+
+    if (clock_dynamic)
+    {
+        XBT_ERROR("Sweeps need a static or array clock_frequency_type.");
+        throw std::runtime_error("Sweeps need a static or array clock_frequency_type.");
+    }
+
+    if (common_mapper_str_to_type(data["mapper_type"]) != COMMON_MAPPER_SIMULATION)
+    {
+        XBT_ERROR("Sweeps run the simulation mapper only.");
+        throw std::runtime_error("Sweeps run the simulation mapper only.");
+    }
+
+    std::string out_file_name = data["out_file_name"];
+    size_t extension_pos = out_file_name.find_last_of("./");
+    if (extension_pos != std::string::npos && out_file_name[extension_pos] == '.' && extension_pos > 0)
+        out_file_name.resize(extension_pos);
+    out_file_name = sweep_data.value("out_file_name", out_file_name + ".csv");
+
+    // Runs keep their results in memory only.
+    data["trace_backend"] = "yaml";
+    data["timeline_file_name"] = "";
+
+    // Concurrent calibrations would pin threads to the same cores and skew flops_per_cycle per combination.
+    if (data.value("flops_per_cycle_calibration_ms", 0u) > 0)
+        XBT_WARN("Sweeps use flops_per_cycle; flops_per_cycle_calibration_ms is ignored.");
+
+    data["flops_per_cycle_calibration_ms"] = 0;
+    data["mapper_mem_arena"] = false;
+    data["mapper_perf_counters"] = false;
+
+    *common = new common_t();
+    runtime_topology_load(*common);
+    runtime_dag_load(*common, dag, data);
+
+    // Cartesian product of the axes (in key order; the last axis varies fastest).
+    runtime_sweep_t sweep;
+    sweep.common = *common;
+    sweep.base = data;
+    sweep.combinations.assign(1, nlohmann::json::object());
+
+    for (const auto &[key, values] : axes.items())
+    {
+        std::vector<nlohmann::json> combinations;
+        for (const nlohmann::json &combination : sweep.combinations)
+        {
+            for (const nlohmann::json &value : values)
+            {
+                combinations.push_back(combination);
+                combinations.back()[key] = value;
+            }
+        }
+        sweep.combinations = combinations;
+    }
+
+    sweep.results.resize(sweep.combinations.size());
+    sweep.next_combination = 0;
+
+    size_t threads_count = sweep_data.value("threads", (size_t) std::max(1u, std::thread::hardware_concurrency()));
+    threads_count = std::max((size_t) 1, std::min(threads_count, sweep.combinations.size()));
+
+    XBT_INFO("Sweep: %zu combinations, %zu threads, execs: %zu.", sweep.combinations.size(), threads_count, (*common)->workflow.exec_names.size());
+
+    std::vector<pthread_t> threads(threads_count);
+    for (size_t i = 0; i < threads_count; ++i)
+    {
+        if (pthread_create(&threads[i], NULL, runtime_sweep_thread_function, &sweep) != 0)
+        {
+            XBT_ERROR("Unable to create sweep thread %zu.", i);
+            throw std::runtime_error("Unable to create sweep thread.");
+        }
+    }
+
+    for (pthread_t thread : threads)
+        pthread_join(thread, NULL);
+
+    // Summary.
+    std::ofstream out(out_file_name);
+    if (!out.is_open())
+    {
+        XBT_ERROR("Could not open file '%s'.", out_file_name.c_str());
+        throw std::runtime_error("Could not open file '" + out_file_name + "'.");
+    }
+
+    out << std::setprecision(12) << "combination";
+    for (const auto &[key, values] : axes.items())
+        out << "," << runtime_csv_quote(key);
+    out << ",status,makespan_us,remote_bytes,scheduling_time_us,decisions\n";
+
+    size_t failed_count = 0;
+    for (size_t i = 0; i < sweep.combinations.size(); ++i)
+    {
+        const runtime_sweep_result_t &result = sweep.results[i];
+        failed_count += !result.completed;
+
+        out << i;
+        for (const auto &[key, value] : sweep.combinations[i].items())
+            out << "," << runtime_csv_quote(value.is_string() ? value.get<std::string>() : value.dump());
+
+        out << "," << (result.completed ? "ok" : "failed");
+        if (result.completed)
+            out << "," << result.makespan_us << "," << result.remote_bytes << "," << result.scheduling_time_us << "," << result.decisions_count;
+        else
+            out << ",,,,";
+        out << "\n";
+    }
+
+    XBT_INFO("Sweep summary: %s (%zu combinations, %zu failed).", out_file_name.c_str(), sweep.combinations.size(), failed_count);
+}
+
 void runtime_finalize(common_t **common, simgrid_execs_t **dag, scheduler_t **scheduler, mapper_t **mapper) {
 
     XBT_INFO("Finalize runtime.");
@@ -148,7 +594,15 @@ void runtime_finalize(common_t **common, simgrid_execs_t **dag, scheduler_t **sc
         }
     };
 
-    if (common && (*common)->topology) hwloc_topology_destroy((*common)->topology);
+    if (common && *common) hardware_clock_frequency_sampler_stop(*common);
+
+    if (common && *common) common_trace_finalize(*common);
+
+    if (common && *common) common_timeline_finalize(*common);
+
+    if (common && *common && (*common)->topology) hardware_numa_arena_finalize(*common);
+
+    if (common && *common && (*common)->topology) hwloc_topology_destroy((*common)->topology);
 
     safe_delete(mapper);
     safe_delete(scheduler);
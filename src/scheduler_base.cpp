@@ -2,17 +2,130 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(base_scheduler, "Messages specific to this module.");
 
-Base_Scheduler::Base_Scheduler(const common_t *common, simgrid_execs_t &dag) : common(common), dag(dag)
+Base_Scheduler::Base_Scheduler(common_t *common, simgrid_execs_t &dag)
+    : common(common), dag(dag), unassigned_execs_count(dag.size())
 {
 }
 
 bool Base_Scheduler::has_next()
 {
-    bool has_unassigned = std::any_of(this->dag.begin(), this->dag.end(),
-                        [](const simgrid::s4u::Exec *exec) { 
-                            return !exec->is_assigned(); 
-                        });
+    return this->unassigned_execs_count > 0;
+}
+
+/**
+ * @brief get_best_core_id, timed into the scheduler stats.
+ */
+std::tuple<int, double> Base_Scheduler::select_best_core_id(unsigned int exec_id)
+{
+    double start_time_us = common_get_monotonic_time_us();
+    std::tuple<int, double> best_core_id = this->get_best_core_id(exec_id);
+    this->common->scheduler_stats.best_core_times_us.push_back(common_get_monotonic_time_us() - start_time_us);
+
+    return best_core_id;
+}
+
+/**
+ * @brief Merge the execs released by the mapper threads into ready_exec_ids.
+ */
+void Base_Scheduler::ready_exec_ids_update()
+{
+    exec_ids_t new_ready_exec_ids = common_execs_ready_take(this->common);
+
+    if (new_ready_exec_ids.empty()) return;
+
+    size_t ready_exec_ids_count = this->ready_exec_ids.size();
+    this->ready_exec_ids.insert(this->ready_exec_ids.end(), new_ready_exec_ids.begin(), new_ready_exec_ids.end());
+    std::inplace_merge(this->ready_exec_ids.begin(), this->ready_exec_ids.begin() + ready_exec_ids_count, this->ready_exec_ids.end());
+}
+
+/**
+ * @brief Remove an exec from ready_exec_ids once a core has been selected for it.
+ */
+void Base_Scheduler::ready_exec_id_set_assigned(unsigned int exec_id)
+{
+    auto it = std::lower_bound(this->ready_exec_ids.begin(), this->ready_exec_ids.end(), exec_id);
+    if (it != this->ready_exec_ids.end() && *it == exec_id)
+        this->ready_exec_ids.erase(it);
+
+    this->unassigned_execs_count -= 1;
+}
+
+/**
+ * @brief Change of the resident bytes of numa_id if exec_id runs on one of its cores.
+ *
+ * Writes follow the first-touch policy (they land on numa_id); the inputs stored on numa_id are released.
+ */
+double Base_Scheduler::get_memory_delta(unsigned int exec_id, int numa_id)
+{
+    double memory_delta_bytes = 0.0;
+
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(this->common, exec_id))
+        memory_delta_bytes += this->common->workflow.comm_payloads[comm_id];
+
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(this->common, exec_id))
+    {
+        numa_mask_t numa_mask = common_comm_id_to_numa_ids_w_get(this->common, comm_id);
+        if (numa_mask & ((numa_mask_t) 1 << numa_id))
+            memory_delta_bytes -= this->common->workflow.comm_payloads[comm_id] / common_numa_mask_count(numa_mask);
+    }
+
+    return memory_delta_bytes;
+}
+
+/**
+ * @brief Time (us) added to a placement on numa_id whose writes would exceed the node budget.
+ *
+ * The excess bytes are charged as written to the nearest other NUMA node (lowest latency),
+ * or to numa_id itself on single-node systems. Infinite if the policy forbids the placement.
+ */
+double Base_Scheduler::get_memory_penalty(int numa_id, double memory_delta_bytes, numa_memory_policy_t policy)
+{
+    if (policy == COMMON_NUMA_MEMORY_POLICY_NONE) return 0.0;
+
+    double budget_bytes = common_numa_id_get_budget_bytes(this->common, numa_id);
+    if (!std::isfinite(budget_bytes)) return 0.0;
+
+    double excess_bytes = common_numa_id_get_resident_bytes(this->common, numa_id) + memory_delta_bytes - budget_bytes;
+    if (excess_bytes <= 0.0) return 0.0;
+
+    if (policy == COMMON_NUMA_MEMORY_POLICY_FORBID) return std::numeric_limits<double>::infinity();
+
+    const distance_matrix_t &distance_lat_ns = this->common->distance_lat_ns;
+    int spill_numa_id = numa_id;
+
+    for (size_t other_numa_id = 0; other_numa_id < distance_lat_ns.size(); ++other_numa_id)
+    {
+        if ((int) other_numa_id == numa_id) continue;
+
+        if (spill_numa_id == numa_id || distance_lat_ns[numa_id][other_numa_id] < distance_lat_ns[numa_id][spill_numa_id])
+            spill_numa_id = other_numa_id;
+    }
+
+    return common_communication_time(this->common, numa_id, spill_numa_id, excess_bytes);
+}
+
+/**
+ * @brief Bytes released by exec_id (inputs read minus outputs written).
+ */
+double Base_Scheduler::get_memory_release(unsigned int exec_id)
+{
+    double memory_release_bytes = 0.0;
+
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(this->common, exec_id))
+        memory_release_bytes += this->common->workflow.comm_payloads[comm_id];
+
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(this->common, exec_id))
+        memory_release_bytes -= this->common->workflow.comm_payloads[comm_id];
+
+    return memory_release_bytes;
+}
+
+/**
+ * @brief Whether a NUMA node is above numa_memory_high_watermark (a fraction of its budget).
+ */
+bool Base_Scheduler::memory_pressure_high()
+{
+    if (this->common->numa_memory_high_watermark <= 0.0) return false;
 
-    return has_unassigned;
-    
+    return common_numa_memory_get_utilization(this->common) >= this->common->numa_memory_high_watermark;
 }
@@ -2,7 +2,7 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(eft_scheduler, "Messages specific to this module.");
 
-EFT_Scheduler::EFT_Scheduler(const common_t *common, simgrid_execs_t &dag) : Base_Scheduler(common, dag)
+EFT_Scheduler::EFT_Scheduler(common_t *common, simgrid_execs_t &dag) : Base_Scheduler(common, dag)
 {
 }
 
@@ -10,96 +10,262 @@ EFT_Scheduler::~EFT_Scheduler()
 {
 }
 
-std::tuple<int, double> EFT_Scheduler::get_best_core_id(const simgrid_exec_t *exec)
+/**
+ * @brief Compute the core-independent terms of the finish time of an exec.
+ *
+ * EST(n_i, p_j) = max(avail[j], max_pred_finish_time), read and write times are
+ * evaluated once per NUMA node instead of once per core.
+ */
+void EFT_Scheduler::get_exec_costs(unsigned int exec_id, eft_exec_costs_t &costs)
 {
-    int best_core_id = -1;
-    double earliest_finish_time_us = std::numeric_limits<double>::max();
+    const char *exec_name = this->common->workflow.exec_names[exec_id].c_str();
+    size_t numa_count = this->common->distance_lat_ns.size();
 
-    // Estimate exec earliest_finish_time for every core_id.
-    std::vector<int> core_id_avail = common_core_id_get_avail(this->common);
+    /* 1. MAX ACTUAL FINISH TIME OF THE PREDECESSORS. */
+    costs.exec_id = exec_id;
+    costs.max_pred_finish_time_us = 0.0;
 
-    for (int core_id : core_id_avail)
-    {
-        /* 1. ESTIMATE EARLIEST_START_TIME(n_i). */
-        double earliest_start_time_us = common_earliest_start_time(this->common, exec->get_name(), core_id);
+    // Match all communication (Task1->Task2) where this task is the destination.
+    id_range_t in_comm_ids = common_exec_id_get_in_comm_ids(this->common, exec_id);
 
-        XBT_DEBUG("task: %s, core_id: %d, earliest_start_time_us: %f", exec->get_cname(), core_id, earliest_start_time_us);
+    for (unsigned int comm_id : in_comm_ids)
+    {
+        unsigned int pred_exec_id = this->common->workflow.comm_src_exec_ids[comm_id];
+        double pred_exec_end_time_offset = std::get<1>(common_exec_id_to_rcw_time_offset_payload_get(this->common, pred_exec_id));
+        costs.max_pred_finish_time_us = std::max(costs.max_pred_finish_time_us, pred_exec_end_time_offset);
+    }
 
-        /* 2. ESTIMATE READ_TIME(EXEC) */
+    costs.flops = this->common->workflow.exec_flops[exec_id];
 
-        double estimated_read_time_us = 0.0;
+    /* 2. ESTIMATE READ_TIME(EXEC) PER NUMA NODE (dst NUMA node of the reading core). */
+    costs.numa_id_to_read_time_us.assign(numa_count, 0.0);
 
-        // Determine the NUMA node corresponding to the core that will perform the reading operation.
-        int read_dst_numa_id = hardware_hwloc_numa_id_get_by_core_id(this->common, core_id);
+    for (unsigned int comm_id : in_comm_ids)
+    {
+        double read_payload_bytes = this->common->workflow.comm_payloads[comm_id];
 
-        // Match all communication (Task1->Task2) where this task_name is the destination.
-        name_to_time_range_payload_t matches = common_comm_name_to_w_time_offset_payload_filter(this->common, exec->get_name());
+        // ASSUMPTION:
+        // For the read time estimation, we assume that the entire data item is stored in a single memory domain, the first one.
+        int read_src_numa_id = common_numa_mask_first(common_comm_id_to_numa_ids_w_get(this->common, comm_id));
 
-        for (const auto &[comm_name, time_range_payload] : matches)
+        for (size_t read_dst_numa_id = 0; read_dst_numa_id < numa_count; ++read_dst_numa_id)
         {
-            double read_payload_bytes = (double) std::get<2>(time_range_payload);
-
-            // ASSUMPTION:
-            // For the read time estimation, we assume that the entire data item is stored in a single memory domain, the first one.
-            int read_src_numa_id = common_comm_name_to_numa_ids_w_get(this->common, comm_name).front();
-            
             double read_time_us = common_communication_time(this->common, read_src_numa_id, read_dst_numa_id, read_payload_bytes);
-            
-            estimated_read_time_us = std::max(estimated_read_time_us, read_time_us);
-            
-            XBT_DEBUG("task: %s, core_id: %d, comm_name: %s, read_time_us: %f, payload: %f, estimated_read_time_us: %f",
-                exec->get_cname(), core_id, comm_name.c_str(), read_time_us, read_payload_bytes, estimated_read_time_us);
+            costs.numa_id_to_read_time_us[read_dst_numa_id] = std::max(costs.numa_id_to_read_time_us[read_dst_numa_id], read_time_us);
         }
+    }
 
-        /* 3. ESTIMATE COMPUTE_TIME(EXEC). */
+    /* 3. ESTIMATE WRITE_TIME(EXEC) PER NUMA NODE. */
+    costs.numa_id_to_write_time_us.assign(numa_count, 0.0);
 
-        double flops = exec->get_remaining();
-        double clock_frequency_hz = hardware_hwloc_core_id_get_clock_frequency(this->common, core_id);
-        double estimated_compute_time_us = common_compute_time(this->common, flops, clock_frequency_hz);
+    // Task_i->end communications are not part of the workflow comms.
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(this->common, exec_id))
+    {
+        double write_payload_bytes = this->common->workflow.comm_payloads[comm_id];
 
-        XBT_DEBUG("task: %s, core_id: %d, estimated_compute_time_us: %f", exec->get_cname(), core_id, estimated_compute_time_us);
+        // ASSUMPTION:
+        // Since it is uncertain which NUMA node will handle the write operations for this task,
+        // writes will follow the first-touch policy, i.e., data will be saved in 
+        // the numa node that share locality with the core_id.
+        for (size_t write_src_numa_id = 0; write_src_numa_id < numa_count; ++write_src_numa_id)
+        {
+            double write_time_us = common_communication_time(this->common, write_src_numa_id, write_src_numa_id, write_payload_bytes);
+            costs.numa_id_to_write_time_us[write_src_numa_id] = std::max(costs.numa_id_to_write_time_us[write_src_numa_id], write_time_us);
+        }
+    }
 
-        /* 4. ESTIMATE WRITE_TIME(EXEC) */
+    for (size_t numa_id = 0; numa_id < numa_count; ++numa_id)
+        XBT_DEBUG("task: %s, numa_id: %zu, estimated_read_time_us: %f, estimated_write_time_us: %f",
+            exec_name, numa_id, costs.numa_id_to_read_time_us[numa_id], costs.numa_id_to_write_time_us[numa_id]);
+}
+
+/**
+ * @brief Estimate the read time of an exec on a core of numa_id.
+ *
+ * With mapper_prefetch, each in-comm is either read remotely or migrated ahead of the start
+ * (see common_comm_id_read_time), so the estimate depends on earliest_start_time_us.
+ */
+double EFT_Scheduler::get_read_time(const eft_exec_costs_t &costs, int numa_id, double earliest_start_time_us)
+{
+    if (!this->common->mapper_prefetch) return costs.numa_id_to_read_time_us[numa_id];
 
-        double estimated_write_time_us = 0.0;
+    double read_time_us = 0.0;
+    double migration_time_us;
 
-        // Retrieve the NUMA node that will perform the write operation.
-        int write_src_numa_id = hardware_hwloc_numa_id_get_by_core_id(this->common, core_id);
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(this->common, costs.exec_id))
+        read_time_us = std::max(read_time_us, common_comm_id_read_time(this->common, comm_id, numa_id, earliest_start_time_us, &migration_time_us));
 
-        for (const auto &succ : exec->get_successors())
-        {
-            const simgrid_comm_t *comm = dynamic_cast<simgrid_comm_t *>(succ.get());
-            double write_payload_bytes = comm->get_remaining();
+    return read_time_us;
+}
 
-            // Skipt all task_i->end communications.
-            auto [exec_name, succ_exec_name] = common_split(comm->get_cname(), "->");
-            if (succ_exec_name == std::string("end")) continue;
+/**
+ * @brief Estimate the finish time of an exec on a single core.
+ */
+double EFT_Scheduler::get_finish_time(const eft_exec_costs_t &costs, int core_id)
+{
+    int numa_id = hardware_hwloc_numa_id_get_by_core_id(this->common, core_id);
 
-            // Determine the NUMA node that will handle the write operation.
-            // ASSUMPTION:
-            // Since it is uncertain which NUMA node will handle the write operations for this task,
-            // writes will follow the first-touch policy, i.e., data will be saved in 
-            // the numa node that share locality with the core_id.
+    double earliest_start_time_us = std::max(common_core_id_get_avail_until(this->common, core_id), costs.max_pred_finish_time_us);
+    double clock_frequency_hz = hardware_hwloc_core_id_get_clock_frequency(this->common, core_id);
+    double estimated_compute_time_us = common_compute_time(this->common, core_id, costs.flops, clock_frequency_hz);
 
-            double write_time_us = common_communication_time(this->common, write_src_numa_id, write_src_numa_id, write_payload_bytes);
-            estimated_write_time_us = std::max(estimated_write_time_us, write_time_us);
+    double estimated_read_time_us = this->get_read_time(costs, numa_id, earliest_start_time_us);
+
+    return earliest_start_time_us + estimated_read_time_us + estimated_compute_time_us + costs.numa_id_to_write_time_us[numa_id];
+}
 
-            XBT_DEBUG("task: %s, core_id: %d, comm_name: %s, write_time_us: %f, payload: %f, estimated_read_time_us: %f",
-                exec->get_cname(), core_id, comm->get_cname(), write_time_us, write_payload_bytes, estimated_read_time_us);
+/**
+ * @brief Group the available cores by NUMA node.
+ */
+void EFT_Scheduler::get_avail_cores(eft_cores_t &cores)
+{
+    size_t numa_count = this->common->distance_lat_ns.size();
+    std::vector<int> core_ids = common_core_id_get_avail(this->common);
+    std::vector<int> core_numa_ids(core_ids.size());
+
+    cores.numa_offsets.assign(numa_count + 1, 0);
+
+    for (size_t i = 0; i < core_ids.size(); ++i)
+    {
+        core_numa_ids[i] = hardware_hwloc_numa_id_get_by_core_id(this->common, core_ids[i]);
+        cores.numa_offsets[core_numa_ids[i] + 1] += 1;
+    }
+
+    for (size_t numa_id = 0; numa_id < numa_count; ++numa_id)
+        cores.numa_offsets[numa_id + 1] += cores.numa_offsets[numa_id];
+
+    cores.core_ids.resize(core_ids.size());
+    cores.avail_until_us.resize(core_ids.size());
+    cores.clock_frequency_hz.resize(core_ids.size());
+    cores.flops_per_cycle.resize(core_ids.size());
+
+    std::vector<unsigned int> numa_fill(cores.numa_offsets.begin(), cores.numa_offsets.end() - 1);
+
+    for (size_t i = 0; i < core_ids.size(); ++i)
+    {
+        unsigned int pos = numa_fill[core_numa_ids[i]]++;
+        cores.core_ids[pos] = core_ids[i];
+        cores.avail_until_us[pos] = common_core_id_get_avail_until(this->common, core_ids[i]);
+        cores.clock_frequency_hz[pos] = hardware_hwloc_core_id_get_clock_frequency(this->common, core_ids[i]);
+        cores.flops_per_cycle[pos] = common_core_id_get_flops_per_cycle(this->common, core_ids[i]);
+    }
+}
+
+/**
+ * @brief Memory penalty of a placement on each NUMA node with available cores (see numa_memory_policy).
+ *
+ * With the forbid policy, if no node fits the budget the placements are penalized instead, so the exec is not stalled.
+ */
+void EFT_Scheduler::get_memory_penalties(unsigned int exec_id, const eft_cores_t &cores, std::vector<double> &penalties)
+{
+    size_t numa_count = cores.numa_offsets.size() - 1;
+    numa_memory_policy_t policy = this->common->numa_memory_policy;
+
+    penalties.assign(numa_count, 0.0);
+
+    if (policy == COMMON_NUMA_MEMORY_POLICY_NONE) return;
+
+    bool any_fits = false;
+
+    for (size_t numa_id = 0; numa_id < numa_count; ++numa_id)
+    {
+        if (cores.numa_offsets[numa_id] == cores.numa_offsets[numa_id + 1]) continue;
+
+        penalties[numa_id] = this->get_memory_penalty(numa_id, this->get_memory_delta(exec_id, numa_id), policy);
+        any_fits = any_fits || std::isfinite(penalties[numa_id]);
+    }
+
+    if (policy != COMMON_NUMA_MEMORY_POLICY_FORBID || any_fits) return;
+
+    XBT_DEBUG("task: %s, no numa node fits the memory budget, penalizing instead.", this->common->workflow.exec_names[exec_id].c_str());
+
+    for (size_t numa_id = 0; numa_id < numa_count; ++numa_id)
+        if (cores.numa_offsets[numa_id] != cores.numa_offsets[numa_id + 1])
+            penalties[numa_id] = this->get_memory_penalty(numa_id, this->get_memory_delta(exec_id, numa_id), COMMON_NUMA_MEMORY_POLICY_PENALIZE);
+}
+
+/**
+ * @brief Select the core with the earliest finish time for an exec.
+ *
+ * Two-level evaluation: the NUMA-dependent terms (read and write times, memory penalty) are computed
+ * once per NUMA node, then the best core of each node is found with a branch-free
+ * pass over contiguous per-core arrays. Ties are broken by the lowest core_id.
+ */
+std::tuple<int, double> EFT_Scheduler::get_best_core_id(unsigned int exec_id)
+{
+    const char *exec_name = this->common->workflow.exec_names[exec_id].c_str();
+
+    int best_core_id = -1;
+    double earliest_finish_time_us = std::numeric_limits<double>::max();
+
+    eft_exec_costs_t &costs = this->exec_costs;
+    eft_cores_t &cores = this->avail_cores;
+
+    this->get_exec_costs(exec_id, costs);
+    this->get_avail_cores(cores);
+    this->get_memory_penalties(exec_id, cores, this->numa_id_to_memory_penalty_us);
+    this->common->scheduler_stats.decision_cores_evaluated += cores.core_ids.size();
+
+    const double max_pred_finish_time_us = costs.max_pred_finish_time_us;
+    const double flops = costs.flops;
+
+    this->finish_times_us.resize(cores.core_ids.size());
+
+    for (size_t numa_id = 0; numa_id + 1 < cores.numa_offsets.size(); ++numa_id)
+    {
+        unsigned int first = cores.numa_offsets[numa_id];
+        unsigned int last = cores.numa_offsets[numa_id + 1];
+
+        if (first == last) continue;
+
+        const double read_time_us = costs.numa_id_to_read_time_us[numa_id];
+        const double write_time_us = costs.numa_id_to_write_time_us[numa_id];
+        const double memory_penalty_us = this->numa_id_to_memory_penalty_us[numa_id];
+
+        const double *avail_until_us = cores.avail_until_us.data();
+        const double *clock_frequency_hz = cores.clock_frequency_hz.data();
+        const double *flops_per_cycle = cores.flops_per_cycle.data();
+        double *finish_times_us = this->finish_times_us.data();
+
+        // Same arithmetic as common_earliest_start_time and common_compute_time.
+        if (!this->common->mapper_prefetch)
+        {
+            for (unsigned int i = first; i < last; ++i)
+            {
+                double earliest_start_time_us = std::max(avail_until_us[i], max_pred_finish_time_us);
+                double estimated_compute_time_us = (flops / (flops_per_cycle[i] * clock_frequency_hz[i])) * 1000000;
+                finish_times_us[i] = earliest_start_time_us + read_time_us + estimated_compute_time_us + write_time_us + memory_penalty_us;
+            }
+        }
+        else
+        {
+            // Migrations overlap with the wait for the core, so the read time is evaluated per core.
+            for (unsigned int i = first; i < last; ++i)
+            {
+                double earliest_start_time_us = std::max(avail_until_us[i], max_pred_finish_time_us);
+                double estimated_read_time_us = this->get_read_time(costs, numa_id, earliest_start_time_us);
+                double estimated_compute_time_us = (flops / (flops_per_cycle[i] * clock_frequency_hz[i])) * 1000000;
+                finish_times_us[i] = earliest_start_time_us + estimated_read_time_us + estimated_compute_time_us + write_time_us + memory_penalty_us;
+            }
         }
 
-        double finish_time_us =
-            earliest_start_time_us + estimated_read_time_us + estimated_compute_time_us + estimated_write_time_us;
+        // Best core inside the NUMA node (cores are in ascending core_id order).
+        unsigned int numa_best = first;
+        for (unsigned int i = first + 1; i < last; ++i)
+            numa_best = (finish_times_us[i] < finish_times_us[numa_best]) ? i : numa_best;
 
-        XBT_DEBUG("task: %s, core_id: %d, finish_time_us: %f", exec->get_cname(), core_id, finish_time_us);
-            
-        if (finish_time_us < earliest_finish_time_us) {
-            best_core_id = core_id;
-            earliest_finish_time_us = finish_time_us;
+        XBT_DEBUG("task: %s, numa_id: %zu, best_core_id: %d, finish_time_us: %f",
+            exec_name, numa_id, cores.core_ids[numa_best], finish_times_us[numa_best]);
+
+        if (finish_times_us[numa_best] < earliest_finish_time_us ||
+            (finish_times_us[numa_best] == earliest_finish_time_us && cores.core_ids[numa_best] < best_core_id))
+        {
+            best_core_id = cores.core_ids[numa_best];
+            earliest_finish_time_us = finish_times_us[numa_best];
         }
     }
 
-    XBT_DEBUG("task: %s, best_core_id: %d, earliest_finish_time_us: %f", exec->get_cname(), best_core_id, earliest_finish_time_us);
+    XBT_DEBUG("task: %s, best_core_id: %d, earliest_finish_time_us: %f", exec_name, best_core_id, earliest_finish_time_us);
 
     return {best_core_id, earliest_finish_time_us};
 }
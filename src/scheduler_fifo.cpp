@@ -2,7 +2,7 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(fifo_scheduler, "Messages specific to this module.");
 
-FIFO_Scheduler::FIFO_Scheduler(const common_t *common, simgrid_execs_t &dag) : Base_Scheduler(common, dag)
+FIFO_Scheduler::FIFO_Scheduler(common_t *common, simgrid_execs_t &dag) : Base_Scheduler(common, dag)
 {
 }
 
@@ -14,7 +14,7 @@ void FIFO_Scheduler::initialize()
 {
 }
 
-std::tuple<int, double> FIFO_Scheduler::get_best_core_id(const simgrid_exec_t *exec)
+std::tuple<int, double> FIFO_Scheduler::get_best_core_id(unsigned int exec_id)
 {
     int best_core_id = -1;
     int best_numa_id = -1;
@@ -23,19 +23,22 @@ std::tuple<int, double> FIFO_Scheduler::get_best_core_id(const simgrid_exec_t *e
 
     if (avail_core_ids.empty()) return {best_core_id, earliest_finish_time_us};
 
+    this->common->scheduler_stats.decision_cores_evaluated += avail_core_ids.size();
+
     // ASSUMPTION:
     // If data item pages are spread across multiple NUMA domains, we assume
     // the data is evenly distributed, i.e., all data pages have the same size.
 
     /* Count the amount of data (bytes) to be read per memory domain. */
     std::unordered_map<int, double> numa_id_to_payload;
-    name_to_time_range_payload_t matches = common_comm_name_to_w_time_offset_payload_filter(this->common, exec->get_name());
+    id_range_t in_comm_ids = common_exec_id_get_in_comm_ids(this->common, exec_id);
 
-    for (const auto &[comm_name, time_range_payload] : matches)
+    for (unsigned int comm_id : in_comm_ids)
     {
-        std::vector<int> numa_ids = common_comm_name_to_numa_ids_w_get(this->common, comm_name);
-        for (int numa_id : numa_ids)
-            numa_id_to_payload[numa_id] += std::get<2>(time_range_payload) / numa_ids.size();
+        numa_mask_t numa_mask = common_comm_id_to_numa_ids_w_get(this->common, comm_id);
+        int numa_ids_count = common_numa_mask_count(numa_mask);
+        for (int numa_id : common_numa_mask_to_ids(numa_mask))
+            numa_id_to_payload[numa_id] += this->common->workflow.comm_payloads[comm_id] / numa_ids_count;
     }
 
     std::string fifo_prioritize_by_core_id = common_scheduler_param_get(common, "fifo_prioritize_by_core_id");
@@ -79,38 +82,56 @@ std::tuple<int, double> FIFO_Scheduler::get_best_core_id(const simgrid_exec_t *e
     best_core_id = all_equal && (this->common->mapper_type == COMMON_MAPPER_SIMULATION) ? common_simulation_find_first_available_core_id(this->common) : best_core_id;
     best_numa_id = hardware_hwloc_numa_id_get_by_core_id(this->common, best_core_id);
 
-    XBT_DEBUG("best_core_id: %d, best_numa_id: %d", best_core_id, best_numa_id);
+    // Memory budget: FIFO does not compare finish times, so with either policy the first core (in the
+    // order above) whose NUMA node fits the budget is taken; if none fits, the least penalized one.
+    double memory_penalty_us = 0.0;
+
+    if (this->common->numa_memory_policy != COMMON_NUMA_MEMORY_POLICY_NONE)
+    {
+        memory_penalty_us = this->get_memory_penalty(best_numa_id, this->get_memory_delta(exec_id, best_numa_id), COMMON_NUMA_MEMORY_POLICY_PENALIZE);
+
+        for (int avail_core_id : avail_core_ids)
+        {
+            if (memory_penalty_us == 0.0) break;
 
-    double earliest_start_time_us = common_earliest_start_time(this->common, exec->get_name(), best_core_id);
+            int core_numa_id = hardware_hwloc_numa_id_get_by_core_id(this->common, avail_core_id);
+            double core_memory_penalty_us = this->get_memory_penalty(core_numa_id, this->get_memory_delta(exec_id, core_numa_id), COMMON_NUMA_MEMORY_POLICY_PENALIZE);
+
+            if (core_memory_penalty_us < memory_penalty_us)
+            {
+                best_core_id = avail_core_id;
+                best_numa_id = core_numa_id;
+                memory_penalty_us = core_memory_penalty_us;
+            }
+        }
+    }
+
+    XBT_DEBUG("best_core_id: %d, best_numa_id: %d, memory_penalty_us: %f", best_core_id, best_numa_id, memory_penalty_us);
+
+    double earliest_start_time_us = common_earliest_start_time(this->common, exec_id, best_core_id);
 
     double estimated_read_time_us = 0.0;
 
-    for (const auto &[comm_name, time_range_payload] : matches)
+    for (unsigned int comm_id : in_comm_ids)
     {
-        double read_payload_bytes = (double) std::get<2>(time_range_payload);
-
         // ASSUMPTION:
         // For the read time estimation, we assume that the entire data item is stored in a single memory domain, the first one.
-        int read_src_numa_id = common_comm_name_to_numa_ids_w_get(this->common, comm_name).front();
-
+        // With mapper_prefetch, the item may be migrated to best_numa_id instead of being read remotely.
+        double migration_time_us;
         estimated_read_time_us = std::max(
-            estimated_read_time_us, common_communication_time(this->common, read_src_numa_id, best_numa_id, read_payload_bytes));
+            estimated_read_time_us, common_comm_id_read_time(this->common, comm_id, best_numa_id, earliest_start_time_us, &migration_time_us));
     }
 
-    double flops = exec->get_remaining();
+    double flops = this->common->workflow.exec_flops[exec_id];
     double clock_frequency_hz = hardware_hwloc_core_id_get_clock_frequency(this->common, best_core_id);
-    double estimated_compute_time_us = common_compute_time(this->common, flops, clock_frequency_hz);
+    double estimated_compute_time_us = common_compute_time(this->common, best_core_id, flops, clock_frequency_hz);
 
     double estimated_write_time_us = 0.0;
 
-    for (const auto &succ : exec->get_successors())
+    // Task_i->end communications are not part of the workflow comms.
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(this->common, exec_id))
     {
-        const simgrid_comm_t *comm = dynamic_cast<simgrid_comm_t *>(succ.get());
-        double write_payload_bytes = comm->get_remaining();
-
-        // Skipt all task_i->end communications.
-        auto [exec_name, succ_exec_name] = common_split(comm->get_cname(), "->");
-        if (succ_exec_name == std::string("end")) continue;
+        double write_payload_bytes = this->common->workflow.comm_payloads[comm_id];
 
         // Determine the NUMA node that will handle the write operation.
         // ASSUMPTION:
@@ -121,81 +142,105 @@ std::tuple<int, double> FIFO_Scheduler::get_best_core_id(const simgrid_exec_t *e
         estimated_write_time_us = std::max(estimated_write_time_us, common_communication_time(this->common, best_numa_id, best_numa_id, write_payload_bytes));
     }
 
-    earliest_finish_time_us = earliest_start_time_us + estimated_read_time_us + estimated_compute_time_us + estimated_write_time_us;
+    earliest_finish_time_us = earliest_start_time_us + estimated_read_time_us + estimated_compute_time_us + estimated_write_time_us + memory_penalty_us;
 
     return {best_core_id, earliest_finish_time_us};
 }
 
-std::tuple<simgrid_exec_t *, int, double> FIFO_Scheduler::next()
+std::tuple<int, int, double> FIFO_Scheduler::next()
 {
     int selected_core_id = -1;  
     double estimated_finish_time = 0.0;  
-    simgrid_exec_t *selected_exec = nullptr;  
+    int selected_exec_id = -1;  
+
+    // Only execs released since the previous call are new to the queue.
+    this->ready_exec_ids_update();
 
-    simgrid_execs_t ready_execs = common_dag_get_ready_execs(this->dag);
+    exec_ids_t ready_exec_ids;
+    ready_exec_ids.swap(this->ready_exec_ids);
 
-    if (ready_execs.empty()) return {selected_exec, selected_core_id, estimated_finish_time};
+    if (ready_exec_ids.empty() && this->queue.empty()) return {selected_exec_id, selected_core_id, estimated_finish_time};
 
-    auto name_to_data_locality_score = this->get_data_locality_scores(ready_execs);
+    auto id_to_data_locality_score = this->get_data_locality_scores(ready_exec_ids);
 
     std::string fifo_prioritize_by_exec_order = common_scheduler_param_get(this->common, "fifo_prioritize_by_exec_order");
     XBT_DEBUG("fifo_prioritize_by_exec_order: %s, enabled: %s", fifo_prioritize_by_exec_order.c_str(), (fifo_prioritize_by_exec_order == "yes") ? "true" : "false");
 
     if(common_scheduler_param_get(common, "fifo_prioritize_by_exec_order") == "yes")
     {
-        std::sort(ready_execs.begin(), ready_execs.end(), [&](simgrid_exec_t *a, simgrid_exec_t *b) {
-            return name_to_data_locality_score[a->get_name()] >
-                name_to_data_locality_score[b->get_name()]; // Higher score first
+        std::sort(ready_exec_ids.begin(), ready_exec_ids.end(), [&](unsigned int a, unsigned int b) {
+            return id_to_data_locality_score[a] > id_to_data_locality_score[b]; // Higher score first
         });
     }
     
-    // Append only new ready tasks to the queue
-    std::unordered_set<simgrid_exec_t *> queue_set(this->queue.begin(), this->queue.end());
+    // Append the new ready tasks to the queue
+    this->queue.insert(this->queue.end(), ready_exec_ids.begin(), ready_exec_ids.end());
 
-    for (const auto &exec : ready_execs) {
-        if (queue_set.insert(exec).second) { // insert returns {iterator, bool}, `true` means new
-            this->queue.push_back(exec);
+    for (unsigned int exec_id : this->queue)
+        XBT_DEBUG("priority_queued_task: %s, score: %f", this->common->workflow.exec_names[exec_id].c_str(), this->compute_data_locality_score(exec_id));
+
+    // Under memory pressure, the queued exec releasing the most bytes goes first (ties by queue order).
+    if (this->memory_pressure_high())
+    {
+        this->common->scheduler_stats.decision_execs_evaluated += this->queue.size() - 1;
+
+        auto selected_it = this->queue.begin();
+        double max_release_bytes = 0.0;
+
+        for (auto it = this->queue.begin(); it != this->queue.end(); ++it)
+        {
+            double release_bytes = this->get_memory_release(*it);
+            if (release_bytes > max_release_bytes)
+            {
+                selected_it = it;
+                max_release_bytes = release_bytes;
+            }
         }
-    }
 
-    for (const auto &exec : this->queue)
-        XBT_DEBUG("priority_queued_task: %s, score: %f", exec->get_cname(), name_to_data_locality_score[exec->get_name()]);
+        if (selected_it != this->queue.begin())
+        {
+            unsigned int exec_id = *selected_it;
+            this->queue.erase(selected_it);
+            this->queue.push_front(exec_id);
+        }
+    }
 
     // Select the best core for execution
-    if (auto [core_id, finish_time] = this->get_best_core_id(this->queue.front()); core_id != -1) {
-        selected_exec = this->queue.front();
+    this->common->scheduler_stats.decision_execs_evaluated += 1;
+
+    if (auto [core_id, finish_time] = this->select_best_core_id(this->queue.front()); core_id != -1) {
+        selected_exec_id = this->queue.front();
         selected_core_id = core_id;
         estimated_finish_time = finish_time;
         this->queue.pop_front();
+        this->ready_exec_id_set_assigned(selected_exec_id);
 
-        XBT_DEBUG("selected_task: %s, selected_core_id: %d, estimated_finish_time: %f", selected_exec->get_cname(), selected_core_id, estimated_finish_time);
+        XBT_DEBUG("selected_task: %s, selected_core_id: %d, estimated_finish_time: %f", this->common->workflow.exec_names[selected_exec_id].c_str(), selected_core_id, estimated_finish_time);
     }
 
-    return std::make_tuple(selected_exec, selected_core_id, estimated_finish_time);
+    return std::make_tuple(selected_exec_id, selected_core_id, estimated_finish_time);
 }
 
-double FIFO_Scheduler::compute_data_locality_score(simgrid_exec_t *exec)
+double FIFO_Scheduler::compute_data_locality_score(unsigned int exec_id)
 {
     double exec_data_locality_score_bytes = 0.0;
 
     // Get all writtings (data items) where this exec is the destionation.
-    name_to_time_range_payload_t matches = common_comm_name_to_w_time_offset_payload_filter(this->common, exec->get_name());
-
-    for (const auto &[comm_name, time_range_payload] : matches)
+    for (unsigned int comm_id : common_exec_id_get_in_comm_ids(this->common, exec_id))
     {
-        exec_data_locality_score_bytes += std::get<2>(time_range_payload);
+        exec_data_locality_score_bytes += this->common->workflow.comm_payloads[comm_id];
     }
 
     return exec_data_locality_score_bytes;
 }
 
-std::unordered_map<std::string, double> FIFO_Scheduler::get_data_locality_scores(simgrid_execs_t &execs)
+std::unordered_map<unsigned int, double> FIFO_Scheduler::get_data_locality_scores(const exec_ids_t &exec_ids)
 {
-    std::unordered_map<std::string, double> name_to_data_locality_scores;
-    for (simgrid_exec_t *exec : execs)
+    std::unordered_map<unsigned int, double> id_to_data_locality_scores;
+    for (unsigned int exec_id : exec_ids)
     {
-        name_to_data_locality_scores[exec->get_name()] = this->compute_data_locality_score(exec);
+        id_to_data_locality_scores[exec_id] = this->compute_data_locality_score(exec_id);
     }
 
-    return name_to_data_locality_scores;
+    return id_to_data_locality_scores;
 }
@@ -2,7 +2,7 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(heft_scheduler, "Messages specific to this module.");
 
-HEFT_Scheduler::HEFT_Scheduler(const common_t *common, simgrid_execs_t &dag) : EFT_Scheduler(common, dag)
+HEFT_Scheduler::HEFT_Scheduler(common_t *common, simgrid_execs_t &dag) : EFT_Scheduler(common, dag)
 {
 }
 
@@ -14,28 +14,30 @@ void HEFT_Scheduler::initialize()
 {
     this->initialize_compute_and_communication_costs();
     this->initialize_all_upward_ranks();
+    this->initialize_rank_orders();
 }
 
 void HEFT_Scheduler::initialize_compute_and_communication_costs()
 {
+    const workflow_t &workflow = this->common->workflow;
     std::vector<int> core_avail = common_core_id_get_avail(this->common);
 
     // Initialize average computation costs.
-    for (simgrid_exec_t *exec : this->dag)
-    {
-        if (exec->get_name() == "end") continue; // Skip this exec
+    this->exec_id_to_cost_seconds.assign(workflow.exec_names.size(), 0.0);
 
-        double flops = exec->get_remaining();
+    for (unsigned int exec_id = 0; exec_id < workflow.exec_names.size(); ++exec_id)
+    {
+        double flops = workflow.exec_flops[exec_id];
         double estimated_compute_time_avg_seconds = 0.0;
 
         for (int core_id : core_avail)
         {
             double clock_frequency_hz = hardware_hwloc_core_id_get_clock_frequency(this->common, core_id);
-            estimated_compute_time_avg_seconds += common_compute_time(this->common, flops, clock_frequency_hz);
+            estimated_compute_time_avg_seconds += common_compute_time(this->common, core_id, flops, clock_frequency_hz);
         }
 
         estimated_compute_time_avg_seconds = estimated_compute_time_avg_seconds / ((double) core_avail.size());
-        this->name_to_cost_seconds[exec->get_cname()] = estimated_compute_time_avg_seconds;
+        this->exec_id_to_cost_seconds[exec_id] = estimated_compute_time_avg_seconds;
     }
 
     // Average lat and bw.
@@ -57,80 +59,157 @@ void HEFT_Scheduler::initialize_compute_and_communication_costs()
     latency_avg_ns = latency_avg_ns / (double) core_avail.size();
     bandwidth_avg_gbps = bandwidth_avg_gbps / (double) core_avail.size();
 
-    // Initialize average communication costs.
-    for (simgrid_exec_t *exec : this->dag)
+    // Initialize average communication costs (task_i->end communications are not part of the workflow comms).
+    this->comm_id_to_cost_seconds.assign(workflow.comm_names.size(), 0.0);
+
+    for (unsigned int comm_id = 0; comm_id < workflow.comm_names.size(); ++comm_id)
     {
-        for (const auto &succ : exec->get_successors())
-        {
-            const simgrid_comm_t *succ_comm = dynamic_cast<simgrid_comm_t *>(succ.get());
-            const simgrid_exec_t *succ_exec = dynamic_cast<simgrid_exec_t *>(succ_comm->get_successors().front().get());
-            if (succ_exec && succ_exec->get_name() != "end")
-            {
-                double payload_bytes = succ_comm->get_remaining();
-                this->name_to_cost_seconds[succ_comm->get_cname()] =
-                    (latency_avg_ns / 1000000000) + (payload_bytes / bandwidth_avg_gbps);
-            }
-        }
+        double payload_bytes = workflow.comm_payloads[comm_id];
+        this->comm_id_to_cost_seconds[comm_id] = (latency_avg_ns / 1000000000) + (payload_bytes / bandwidth_avg_gbps);
     }
 }
 
-double HEFT_Scheduler::compute_upward_rank(simgrid_exec_t *exec)
+double HEFT_Scheduler::compute_upward_rank(unsigned int exec_id)
 {
     // If already computed, return cached value
-    if (upward_ranks.find(exec->get_name()) != upward_ranks.end())
-        return upward_ranks[exec->get_name()];
+    if (this->upward_ranks[exec_id] >= 0.0)
+        return this->upward_ranks[exec_id];
 
-    double exec_cost = name_to_cost_seconds[exec->get_name()];
+    double exec_cost = this->exec_id_to_cost_seconds[exec_id];
 
     // Compute max successor rank
     double max_successor_rank = 0.0;
-    for (auto &succ : exec->get_successors())
+    for (unsigned int comm_id : common_exec_id_get_out_comm_ids(this->common, exec_id))
     {
-        simgrid_comm_t *succ_comm = dynamic_cast<simgrid_comm_t *>(succ.get());
-
-        simgrid_exec_t *succ_exec = dynamic_cast<simgrid_exec_t *>(succ_comm->get_successors().front().get());
-        double comm_cost = succ_exec->get_name() == "end" ? 0.0 : name_to_cost_seconds[succ_comm->get_name()];
-        double succ_rank = succ_exec->get_name() == "end" ? 0.0 : compute_upward_rank(succ_exec);
+        double comm_cost = this->comm_id_to_cost_seconds[comm_id];
+        double succ_rank = compute_upward_rank(this->common->workflow.comm_dst_exec_ids[comm_id]);
         max_successor_rank = std::max(max_successor_rank, comm_cost + succ_rank);
     }
 
     // Compute and cache upward rank
     double rank = exec_cost + max_successor_rank;
-    upward_ranks[exec->get_name()] = rank;
+    this->upward_ranks[exec_id] = rank;
     return rank;
 }
 
 void HEFT_Scheduler::initialize_all_upward_ranks()
 {
-    for (simgrid_exec_t *task : dag)
-        compute_upward_rank(task);
+    // Negative values mark ranks not computed yet.
+    this->upward_ranks.assign(this->common->workflow.exec_names.size(), -1.0);
+
+    for (unsigned int exec_id = 0; exec_id < this->upward_ranks.size(); ++exec_id)
+        compute_upward_rank(exec_id);
 }
 
-std::tuple<simgrid_exec_t *, int, double> HEFT_Scheduler::next()
+/**
+ * @brief Turn the upward ranks into integer priorities.
+ *
+ * Upward ranks are fixed after initialization, so execs are sorted once by upward rank
+ * (descending order, ties broken by exec_id) and the ready heap only compares integers.
+ */
+void HEFT_Scheduler::initialize_rank_orders()
+{
+    size_t execs_count = this->upward_ranks.size();
+
+    this->rank_order_to_exec_id.resize(execs_count);
+    std::iota(this->rank_order_to_exec_id.begin(), this->rank_order_to_exec_id.end(), 0);
+
+    std::stable_sort(this->rank_order_to_exec_id.begin(), this->rank_order_to_exec_id.end(), [this](unsigned int a, unsigned int b) {
+        return this->upward_ranks[a] > this->upward_ranks[b]; // Higher rank first
+    });
+
+    this->exec_id_to_rank_order.resize(execs_count);
+    for (unsigned int rank_order = 0; rank_order < execs_count; ++rank_order)
+        this->exec_id_to_rank_order[this->rank_order_to_exec_id[rank_order]] = rank_order;
+
+    this->ready_heap.clear();
+    this->ready_heap.reserve(execs_count);
+}
+
+/**
+ * @brief Insert newly ready execs into the ready heap.
+ *
+ * Small batches are pushed one by one (O(k log n)); large batches are appended
+ * and the heap is rebuilt in linear time.
+ */
+void HEFT_Scheduler::ready_heap_push(const exec_ids_t &exec_ids)
+{
+    size_t heap_size = this->ready_heap.size();
+
+    for (unsigned int exec_id : exec_ids)
+        this->ready_heap.push_back(this->exec_id_to_rank_order[exec_id]);
+
+    if (exec_ids.size() > heap_size)
+    {
+        std::make_heap(this->ready_heap.begin(), this->ready_heap.end(), std::greater<unsigned int>());
+        return;
+    }
+
+    for (size_t i = heap_size; i < this->ready_heap.size(); ++i)
+        std::push_heap(this->ready_heap.begin(), this->ready_heap.begin() + i + 1, std::greater<unsigned int>());
+}
+
+std::tuple<int, int, double> HEFT_Scheduler::next()
 {
     int selected_core_id = -1;
     double estimated_finish_time = 0.0;
-    simgrid_exec_t *selected_exec = nullptr;
+    int selected_exec_id = -1;
 
-    // Sort by upward rank (descending order)
-    simgrid_execs_t ready_execs = common_dag_get_ready_execs(this->dag);
+    // Move the execs released since the previous call to the ready heap.
+    this->ready_exec_ids_update();
+    this->ready_heap_push(this->ready_exec_ids);
+    this->ready_exec_ids.clear();
 
-    if (ready_execs.empty())
-        return std::make_tuple(selected_exec, selected_core_id, estimated_finish_time);
+    if (this->ready_heap.empty())
+        return std::make_tuple(selected_exec_id, selected_core_id, estimated_finish_time);
 
-    std::sort(ready_execs.begin(), ready_execs.end(), [this](simgrid_exec_t *a, simgrid_exec_t *b) {
-        return this->upward_ranks[a->get_name()] > this->upward_ranks[b->get_name()]; // Higher rank first
-    });
+    // The highest upward rank is on top of the heap.
+    size_t selected_heap_pos = 0;
+
+    // Under memory pressure, the ready exec releasing the most bytes goes first (ties by upward rank).
+    if (this->memory_pressure_high())
+    {
+        this->common->scheduler_stats.decision_execs_evaluated += this->ready_heap.size() - 1;
+
+        double max_release_bytes = 0.0;
+
+        for (size_t heap_pos = 0; heap_pos < this->ready_heap.size(); ++heap_pos)
+        {
+            double release_bytes = this->get_memory_release(this->rank_order_to_exec_id[this->ready_heap[heap_pos]]);
 
-    for (simgrid_exec_t *exec : ready_execs) {
-        XBT_DEBUG("priority_queued_task: %s, upward_rank: %f", exec->get_cname(), this->upward_ranks[exec->get_name()]);
+            if (release_bytes > max_release_bytes ||
+                (release_bytes == max_release_bytes && release_bytes > 0.0 && this->ready_heap[heap_pos] < this->ready_heap[selected_heap_pos]))
+            {
+                selected_heap_pos = heap_pos;
+                max_release_bytes = release_bytes;
+            }
+        }
     }
 
-    selected_exec = ready_execs.front();
+    selected_exec_id = this->rank_order_to_exec_id[this->ready_heap[selected_heap_pos]];
+
+    XBT_DEBUG("priority_queued_tasks: %zu, top_task: %s, upward_rank: %f", this->ready_heap.size(),
+        this->common->workflow.exec_names[selected_exec_id].c_str(), this->upward_ranks[selected_exec_id]);
+
+    this->common->scheduler_stats.decision_execs_evaluated += 1;
+    std::tie(selected_core_id, estimated_finish_time) = this->select_best_core_id(selected_exec_id);
 
-    std::tie(selected_core_id, estimated_finish_time) = this->get_best_core_id(selected_exec);
+    if (selected_core_id != -1)
+    {
+        if (selected_heap_pos == 0)
+        {
+            std::pop_heap(this->ready_heap.begin(), this->ready_heap.end(), std::greater<unsigned int>());
+            this->ready_heap.pop_back();
+        } else {
+            this->ready_heap[selected_heap_pos] = this->ready_heap.back();
+            this->ready_heap.pop_back();
+            std::make_heap(this->ready_heap.begin(), this->ready_heap.end(), std::greater<unsigned int>());
+        }
+
+        this->ready_exec_id_set_assigned(selected_exec_id);
+    }
 
-    XBT_DEBUG("selected_task: %s, selected_core_id: %d, estimated_finish_time: %f", selected_exec->get_cname(), selected_core_id, estimated_finish_time);
+    XBT_DEBUG("selected_task: %s, selected_core_id: %d, estimated_finish_time: %f", this->common->workflow.exec_names[selected_exec_id].c_str(), selected_core_id, estimated_finish_time);
 
-    return std::make_tuple(selected_exec, selected_core_id, estimated_finish_time);
+    return std::make_tuple(selected_exec_id, selected_core_id, estimated_finish_time);
 }
@@ -2,7 +2,7 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(min_min_scheduler, "Messages specific to this module.");
 
-MIN_MIN_Scheduler::MIN_MIN_Scheduler(const common_t *common, simgrid_execs_t &dag) : EFT_Scheduler(common, dag)
+MIN_MIN_Scheduler::MIN_MIN_Scheduler(common_t *common, simgrid_execs_t &dag) : EFT_Scheduler(common, dag)
 {
 }
 
@@ -12,28 +12,180 @@ MIN_MIN_Scheduler::~MIN_MIN_Scheduler()
 
 void MIN_MIN_Scheduler::initialize()
 {
+    this->cores_count = this->common->core_avail.size();
+
+    this->row_exec_ids.clear();
+    this->row_exec_costs.clear();
+    this->finish_times.clear();
+    this->row_best_core_ids.clear();
+    this->row_best_finish_times.clear();
+
+    // NaN never compares equal, so every column is computed on the first call.
+    this->core_avail_snapshot.assign(this->cores_count, false);
+    this->core_avail_until_snapshot.assign(this->cores_count, std::numeric_limits<double>::quiet_NaN());
 }
 
-std::tuple<simgrid_exec_t *, int, double> MIN_MIN_Scheduler::next()
+/**
+ * @brief Cores whose availability changed since the matrix was last updated.
+ *
+ * The core-independent terms of a ready exec are cached per row (eft_exec_costs_t), and
+ * its finish time only depends on the core through its availability, so only these
+ * columns need to be recomputed. Dynamic clock frequencies can change at
+ * any time, so every column is recomputed in that case.
+ */
+std::vector<int> MIN_MIN_Scheduler::get_dirty_core_ids()
+{
+    std::vector<int> dirty_core_ids;
+    bool all_dirty = (this->common->clock_frequency_type == COMMON_DYNAMIC_CLOCK_FREQUENCY);
+
+    for (size_t core_id = 0; core_id < this->cores_count; ++core_id)
+    {
+        bool core_avail = this->common->core_avail[core_id];
+        double core_avail_until = common_core_id_get_avail_until(this->common, core_id);
+
+        if (all_dirty || core_avail != this->core_avail_snapshot[core_id] || !(core_avail_until == this->core_avail_until_snapshot[core_id]))
+        {
+            this->core_avail_snapshot[core_id] = core_avail;
+            this->core_avail_until_snapshot[core_id] = core_avail_until;
+            dirty_core_ids.push_back(core_id);
+        }
+    }
+
+    return dirty_core_ids;
+}
+
+/**
+ * @brief Recompute the given columns of a row and keep its minimum up to date.
+ *
+ * Ties are broken by the lowest core_id, as EFT_Scheduler::get_best_core_id does.
+ */
+void MIN_MIN_Scheduler::row_update(size_t row, const std::vector<int> &core_ids)
+{
+    const eft_exec_costs_t &exec_costs = this->row_exec_costs[row];
+    double *row_finish_times = &(this->finish_times[row * this->cores_count]);
+
+    int &best_core_id = this->row_best_core_ids[row];
+    double &best_finish_time = this->row_best_finish_times[row];
+    bool rescan = false;
+
+    this->common->scheduler_stats.decision_cores_evaluated += core_ids.size();
+
+    for (int core_id : core_ids)
+    {
+        double finish_time = this->core_avail_snapshot[core_id] ? this->get_finish_time(exec_costs, core_id) : std::numeric_limits<double>::infinity();
+        row_finish_times[core_id] = finish_time;
+
+        if (core_id == best_core_id)
+            rescan = true;
+        else if (finish_time < best_finish_time || (finish_time == best_finish_time && core_id < best_core_id))
+        {
+            best_core_id = core_id;
+            best_finish_time = finish_time;
+        }
+    }
+
+    // The previous minimum changed; fall back to a scan of the cached row.
+    if (rescan)
+    {
+        best_core_id = -1;
+        best_finish_time = std::numeric_limits<double>::max();
+
+        for (size_t core_id = 0; core_id < this->cores_count; ++core_id)
+        {
+            if (row_finish_times[core_id] < best_finish_time)
+            {
+                best_core_id = core_id;
+                best_finish_time = row_finish_times[core_id];
+            }
+        }
+    }
+}
+
+void MIN_MIN_Scheduler::row_append(unsigned int exec_id)
+{
+    this->row_exec_ids.push_back(exec_id);
+    this->row_exec_costs.emplace_back();
+    this->get_exec_costs(exec_id, this->row_exec_costs.back());
+    this->finish_times.resize(this->finish_times.size() + this->cores_count, std::numeric_limits<double>::infinity());
+    this->row_best_core_ids.push_back(-1);
+    this->row_best_finish_times.push_back(std::numeric_limits<double>::max());
+
+    std::vector<int> core_ids(this->cores_count);
+    std::iota(core_ids.begin(), core_ids.end(), 0);
+
+    this->row_update(this->row_exec_ids.size() - 1, core_ids);
+}
+
+void MIN_MIN_Scheduler::row_remove(size_t row)
+{
+    // Move the last row into the removed one.
+    size_t last_row = this->row_exec_ids.size() - 1;
+
+    if (row != last_row)
+    {
+        this->row_exec_ids[row] = this->row_exec_ids[last_row];
+        this->row_exec_costs[row] = std::move(this->row_exec_costs[last_row]);
+        this->row_best_core_ids[row] = this->row_best_core_ids[last_row];
+        this->row_best_finish_times[row] = this->row_best_finish_times[last_row];
+        std::copy_n(this->finish_times.begin() + last_row * this->cores_count, this->cores_count,
+            this->finish_times.begin() + row * this->cores_count);
+    }
+
+    this->row_exec_ids.pop_back();
+    this->row_exec_costs.pop_back();
+    this->row_best_core_ids.pop_back();
+    this->row_best_finish_times.pop_back();
+    this->finish_times.resize(last_row * this->cores_count);
+}
+
+std::tuple<int, int, double> MIN_MIN_Scheduler::next()
 {
     int selected_core_id = -1;
     double estimated_finish_time = std::numeric_limits<double>::max();
-    simgrid_exec_t *selected_exec = nullptr;
+    int selected_exec_id = -1;
+
+    // 1. Recompute the columns of the cores that changed since the previous call.
+    std::vector<int> dirty_core_ids = this->get_dirty_core_ids();
+
+    if (!dirty_core_ids.empty())
+        for (size_t row = 0; row < this->row_exec_ids.size(); ++row)
+            this->row_update(row, dirty_core_ids);
+
+    // 2. Add a row per newly ready exec.
+    this->ready_exec_ids_update();
+
+    for (unsigned int exec_id : this->ready_exec_ids)
+        this->row_append(exec_id);
 
-    for (simgrid_exec_t *exec : common_dag_get_ready_execs(this->dag))
+    this->ready_exec_ids.clear();
+
+    XBT_DEBUG("ready_execs: %zu, dirty_core_ids: %zu", this->row_exec_ids.size(), dirty_core_ids.size());
+
+    // 3. Select the exec with the minimum finish time (ties are broken by the lowest exec_id).
+    size_t selected_row = 0;
+    this->common->scheduler_stats.decision_execs_evaluated += this->row_exec_ids.size();
+
+    for (size_t row = 0; row < this->row_exec_ids.size(); ++row)
     {
-        int core_id;
-        double finish_time;
+        if (this->row_best_core_ids[row] == -1) continue;
 
-        std::tie(core_id, finish_time) = this->get_best_core_id(exec);
+        int exec_id = this->row_exec_ids[row];
+        double finish_time = this->row_best_finish_times[row];
 
-        if (finish_time < estimated_finish_time)
+        if (finish_time < estimated_finish_time || (finish_time == estimated_finish_time && exec_id < selected_exec_id))
         {
-            selected_exec = exec;
-            selected_core_id = core_id;
+            selected_row = row;
+            selected_exec_id = exec_id;
+            selected_core_id = this->row_best_core_ids[row];
             estimated_finish_time = finish_time;
         }
     }
 
-    return std::make_tuple(selected_exec, selected_core_id, estimated_finish_time);
+    if (selected_core_id != -1)
+    {
+        this->row_remove(selected_row);
+        this->ready_exec_id_set_assigned(selected_exec_id);
+    }
+
+    return std::make_tuple(selected_exec_id, selected_core_id, estimated_finish_time);
 }
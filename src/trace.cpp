@@ -0,0 +1,268 @@
+#include "trace.hpp"
+
+#include <xbt/log.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(trace, "Messages specific to this module.");
+
+trace_backend_t trace_backend_str_to_type(const std::string &type)
+{
+    if (type.compare("yaml") == 0) return TRACE_BACKEND_YAML;
+    if (type.compare("binary") == 0) return TRACE_BACKEND_BINARY;
+
+    XBT_ERROR("Unsupported trace backend type '%s'.", type.c_str());
+    throw std::runtime_error("Unsupported trace backend type '" + type + "'.");
+}
+
+std::string trace_backend_type_to_str(const trace_backend_t &type)
+{
+    switch (type) {
+        case TRACE_BACKEND_YAML: return "yaml";
+        case TRACE_BACKEND_BINARY: return "binary";
+        default: return "";
+    }
+}
+
+static size_t trace_file_bytes(size_t records)
+{
+    return sizeof(trace_header_t) + records * sizeof(trace_record_t);
+}
+
+static void trace_map(trace_writer_t &writer, size_t capacity_records)
+{
+    if (ftruncate(writer.fd, trace_file_bytes(capacity_records)) != 0)
+    {
+        XBT_ERROR("Failed to resize trace file '%s': %s", writer.file_name.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to resize trace file.");
+    }
+
+    void *base = (writer.base == nullptr)
+        ? mmap(nullptr, trace_file_bytes(capacity_records), PROT_READ | PROT_WRITE, MAP_SHARED, writer.fd, 0)
+        : mremap(writer.base, trace_file_bytes(writer.capacity_records), trace_file_bytes(capacity_records), MREMAP_MAYMOVE);
+
+    if (base == MAP_FAILED)
+    {
+        XBT_ERROR("Failed to map trace file '%s': %s", writer.file_name.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to map trace file.");
+    }
+
+    writer.base = (char *) base;
+    writer.capacity_records = capacity_records;
+}
+
+/**
+ * @brief Create (truncate) the trace file and map room for capacity_records records.
+ *
+ * The capacity is only a hint; the file doubles when it fills up.
+ */
+void trace_open(trace_writer_t &writer, const std::string &file_name, size_t capacity_records)
+{
+    writer.file_name = file_name;
+    writer.base = nullptr;
+    writer.capacity_records = 0;
+    writer.records_count = 0;
+    writer.lock = PTHREAD_RWLOCK_INITIALIZER;
+
+    writer.fd = open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (writer.fd < 0)
+    {
+        XBT_ERROR("Failed to open trace file '%s': %s", file_name.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to open trace file '" + file_name + "'.");
+    }
+
+    trace_map(writer, std::max<size_t>(capacity_records, 1024));
+
+    trace_header_t *header = (trace_header_t *) writer.base;
+    memcpy(header->magic, TRACE_MAGIC, sizeof(header->magic));
+    header->version = TRACE_VERSION;
+    header->record_bytes = sizeof(trace_record_t);
+
+    XBT_INFO("Trace file: %s (capacity %zu records)", file_name.c_str(), writer.capacity_records);
+}
+
+void trace_append(trace_writer_t &writer, const trace_record_t &record)
+{
+    pthread_rwlock_rdlock(&writer.lock);
+    size_t index = writer.records_count.fetch_add(1, std::memory_order_relaxed);
+
+    while (index >= writer.capacity_records)
+    {
+        pthread_rwlock_unlock(&writer.lock);
+        pthread_rwlock_wrlock(&writer.lock);
+
+        // Another appender may have grown the file meanwhile.
+        if (index >= writer.capacity_records)
+            trace_map(writer, std::max(2 * writer.capacity_records, index + 1));
+
+        pthread_rwlock_unlock(&writer.lock);
+        pthread_rwlock_rdlock(&writer.lock);
+    }
+
+    ((trace_record_t *) (writer.base + sizeof(trace_header_t)))[index] = record;
+    pthread_rwlock_unlock(&writer.lock);
+}
+
+static void trace_strings_append(std::string &strings, const std::string &str)
+{
+    uint32_t length = str.size();
+    strings.append((const char *) &length, sizeof(length));
+    strings.append(str);
+}
+
+/**
+ * @brief Complete the header, append the string table and trim the file to its final size.
+ *
+ * Must be called once all the appenders are done. Does nothing if the writer is not open.
+ */
+void trace_close(trace_writer_t &writer, const std::vector<std::string> &exec_names, const std::vector<std::string> &comm_names,
+    const std::vector<std::string> &counter_names, const std::string &counters_source)
+{
+    if (writer.base == nullptr) return;
+
+    size_t records_count = writer.records_count.load();
+
+    std::string strings;
+    for (const std::string &name : exec_names) trace_strings_append(strings, name);
+    for (const std::string &name : comm_names) trace_strings_append(strings, name);
+    for (const std::string &name : counter_names) trace_strings_append(strings, name);
+    trace_strings_append(strings, counters_source);
+
+    trace_header_t *header = (trace_header_t *) writer.base;
+    header->records_count = records_count;
+    header->strings_offset = trace_file_bytes(records_count);
+    header->execs_count = exec_names.size();
+    header->comms_count = comm_names.size();
+    header->counters_count = counter_names.size();
+
+    munmap(writer.base, trace_file_bytes(writer.capacity_records));
+    writer.base = nullptr;
+
+    if (ftruncate(writer.fd, trace_file_bytes(records_count)) != 0 ||
+        pwrite(writer.fd, strings.data(), strings.size(), trace_file_bytes(records_count)) != (ssize_t) strings.size())
+    {
+        XBT_ERROR("Failed to write the string table of trace file '%s': %s", writer.file_name.c_str(), strerror(errno));
+        close(writer.fd);
+        throw std::runtime_error("Failed to write trace file.");
+    }
+
+    close(writer.fd);
+    writer.fd = -1;
+
+    XBT_INFO("Trace file: %s (%zu records)", writer.file_name.c_str(), records_count);
+}
+
+/* TIMELINE */
+static std::string trace_json_escape(const std::string &str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\') escaped.push_back('\\');
+        escaped.push_back(c);
+    }
+
+    return escaped;
+}
+
+// Writes the separator and the event; the caller holds the mutex.
+static void trace_timeline_event(trace_timeline_t &timeline, const std::string &event)
+{
+    fputs(timeline.events_count++ ? ",\n" : "\n", timeline.file);
+    fputs(event.c_str(), timeline.file);
+}
+
+void trace_timeline_open(trace_timeline_t &timeline, const std::string &file_name)
+{
+    timeline.events_count = 0;
+    timeline.mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    timeline.file = fopen(file_name.c_str(), "w");
+    if (!timeline.file)
+    {
+        XBT_ERROR("Failed to open timeline file '%s': %s", file_name.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to open timeline file '" + file_name + "'.");
+    }
+
+    fputs("{\"traceEvents\": [", timeline.file);
+
+    XBT_INFO("Timeline file: %s", file_name.c_str());
+}
+
+/**
+ * @brief Name and order the track of core_id (thread) within its NUMA node (process).
+ */
+void trace_timeline_track(trace_timeline_t &timeline, int numa_id, int core_id)
+{
+    if (!timeline.file) return;
+
+    std::string pid = std::to_string(numa_id);
+    std::string tid = std::to_string(core_id);
+
+    pthread_mutex_lock(&timeline.mutex);
+    trace_timeline_event(timeline, "{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": " + pid + ", \"args\": {\"name\": \"numa " + pid + "\"}}");
+    trace_timeline_event(timeline, "{\"ph\": \"M\", \"name\": \"process_sort_index\", \"pid\": " + pid + ", \"args\": {\"sort_index\": " + pid + "}}");
+    trace_timeline_event(timeline, "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " + pid + ", \"tid\": " + tid + ", \"args\": {\"name\": \"core " + tid + "\"}}");
+    trace_timeline_event(timeline, "{\"ph\": \"M\", \"name\": \"thread_sort_index\", \"pid\": " + pid + ", \"tid\": " + tid + ", \"args\": {\"sort_index\": " + tid + "}}");
+    pthread_mutex_unlock(&timeline.mutex);
+}
+
+/**
+ * @brief Complete event ("X") on the track of core_id; args is a JSON object body (may be empty).
+ */
+void trace_timeline_slice(trace_timeline_t &timeline, const char *category, const std::string &name, int numa_id, int core_id,
+    double start_us, double end_us, const std::string &args)
+{
+    if (!timeline.file) return;
+
+    char times[96];
+    snprintf(times, sizeof(times), "\"ts\": %.3f, \"dur\": %.3f", start_us, end_us - start_us);
+
+    std::string event = std::string("{\"ph\": \"X\", \"cat\": \"") + category + "\", \"name\": \"" + trace_json_escape(name) +
+        "\", \"pid\": " + std::to_string(numa_id) + ", \"tid\": " + std::to_string(core_id) + ", " + times +
+        ", \"args\": {" + args + "}}";
+
+    pthread_mutex_lock(&timeline.mutex);
+    trace_timeline_event(timeline, event);
+    pthread_mutex_unlock(&timeline.mutex);
+}
+
+/**
+ * @brief Flow start ("s") or end ("f") event; it binds to the slice enclosing time_us on the track of core_id.
+ */
+void trace_timeline_flow(trace_timeline_t &timeline, bool flow_start, unsigned int flow_id, const std::string &name, int numa_id, int core_id,
+    double time_us)
+{
+    if (!timeline.file) return;
+
+    char ts[48];
+    snprintf(ts, sizeof(ts), "\"ts\": %.3f", time_us);
+
+    std::string event = std::string("{\"ph\": \"") + (flow_start ? "s" : "f") + "\", \"cat\": \"comm\", \"name\": \"" + trace_json_escape(name) + "\", \"id\": " +
+        std::to_string(flow_id) + ", \"pid\": " + std::to_string(numa_id) + ", \"tid\": " + std::to_string(core_id) + ", " + ts +
+        (flow_start ? "" : ", \"bp\": \"e\"") + "}";
+
+    pthread_mutex_lock(&timeline.mutex);
+    trace_timeline_event(timeline, event);
+    pthread_mutex_unlock(&timeline.mutex);
+}
+
+void trace_timeline_close(trace_timeline_t &timeline)
+{
+    if (!timeline.file) return;
+
+    fputs("\n]}\n", timeline.file);
+    fclose(timeline.file);
+    timeline.file = nullptr;
+
+    XBT_INFO("Timeline file: %zu events", timeline.events_count);
+}
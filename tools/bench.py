@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+
+"""
+Scheduler overhead benchmark: runs every scheduler_type with the simulation mapper over synthetic
+workflows (tools/dag_generator.py) and writes one CSV row per run:
+
+    shape, tasks, edges, scheduler, status, wall_time_s, next_count, next_p50_us, next_p99_us, next_max_us,
+    peak_rss_kb, makespan_us
+
+next_* come from the scheduler_stats section of the output (scheduler.next() latency), the makespan is the
+latest core_availability, and the peak RSS is the one of the nflows process. Runs use the binary trace
+backend, so the output file stays small for large workflows.
+"""
+
+import argparse
+import csv
+import glob
+import json
+import math
+import os
+import subprocess
+import sys
+import time
+
+import yaml
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import dag_generator
+
+SCHEDULERS = ["fifo", "heft", "min-min"]
+
+def shape_dimensions(shape, tasks):
+    """(width, depth) giving about `tasks` tasks for a shape."""
+    side = max(1, int(round(math.sqrt(tasks))))
+    if shape == "fork-join":
+        return side, max(1, tasks // (side + 1))
+    if shape == "montage":
+        return max(2, int(tasks / 3.75)), 1
+    if shape == "epigenomics":
+        return max(1, (tasks - 4) // 4), 1
+    if shape in ("in-tree", "out-tree"):
+        return 2, max(1, int(round(math.log2(tasks + 1))))
+    return side, max(1, tasks // side)
+
+def system_cores():
+    """Number of cores (not PUs) reported by sysfs."""
+    cores = set()
+    for path in glob.glob("/sys/devices/system/cpu/cpu[0-9]*/topology"):
+        try:
+            with open(f"{path}/physical_package_id") as package, open(f"{path}/core_id") as core:
+                cores.add((package.read().strip(), core.read().strip()))
+        except OSError:
+            pass
+    return len(cores) or os.cpu_count() or 1
+
+def system_numa_nodes():
+    return len(glob.glob("/sys/devices/system/node/node[0-9]*")) or 1
+
+def write_matrix(path, numa_nodes, local, remote):
+    with open(path, "w") as file:
+        file.write(f"{numa_nodes}\n")
+        for i in range(numa_nodes):
+            file.write(" ".join(str(local if i == j else remote) for j in range(numa_nodes)) + "\n")
+
+def run(nflows, config_path, timeout_s):
+    """Returns (status, wall_time_s, peak_rss_kb) of an nflows run."""
+    with open(config_path.replace(".json", ".log"), "w") as log:
+        start = time.monotonic()
+        process = subprocess.Popen([nflows, config_path], stdout=log, stderr=subprocess.STDOUT)
+
+        # os.wait4 reports the resource usage of this child only.
+        deadline = start + timeout_s
+        while True:
+            pid, status, usage = os.wait4(process.pid, os.WNOHANG)
+            if pid != 0:
+                break
+            if time.monotonic() > deadline:
+                process.kill()
+                pid, status, usage = os.wait4(process.pid, 0)
+                return "timeout", time.monotonic() - start, usage.ru_maxrss
+            time.sleep(0.01)
+
+    wall_time_s = time.monotonic() - start
+    return ("ok" if os.waitstatus_to_exitcode(status) == 0 else "failed"), wall_time_s, usage.ru_maxrss
+
+def read_results(out_path):
+    """(next_count, next_p50_us, next_p99_us, next_max_us, makespan_us) from an nflows output file."""
+    with open(out_path) as file:
+        data = yaml.load(file, Loader=getattr(yaml, "CSafeLoader", yaml.SafeLoader))
+
+    next_us = (data.get("scheduler_stats") or {}).get("next_us", {})
+    cores = (data.get("runtime") or {}).get("core_availability", {})
+    makespan_us = max((core["avail_until"] for core in cores.values()), default="")
+
+    return next_us.get("count", ""), next_us.get("p50", ""), next_us.get("p99", ""), next_us.get("max", ""), makespan_us
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the schedulers on synthetic workflows (simulation mapper).")
+    parser.add_argument("--nflows", default="./bin/nflows")
+    parser.add_argument("--out-dir", default="./tests/output/bench")
+    parser.add_argument("--shapes", default=",".join(dag_generator.SHAPES))
+    parser.add_argument("--sizes", default="1000,10000", help="Approximate task counts")
+    parser.add_argument("--schedulers", default=",".join(SCHEDULERS))
+    parser.add_argument("--ccr", type=float, default=1.0)
+    parser.add_argument("--flops-dist", default="lognormal", choices=dag_generator.DISTRIBUTIONS)
+    parser.add_argument("--payload-dist", default="lognormal", choices=dag_generator.DISTRIBUTIONS)
+    parser.add_argument("--cores", type=int, default=None, help="Available cores (default: all)")
+    parser.add_argument("--numa-nodes", type=int, default=None, help="Size of the distance matrices (default: system)")
+    parser.add_argument("--timeout", type=float, default=600, help="Per run (seconds)")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--csv", default=None, help="Output CSV (default: <out-dir>/bench.csv)")
+    args = parser.parse_args()
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    csv_path = args.csv or os.path.join(args.out_dir, "bench.csv")
+
+    cores = args.cores or system_cores()
+    numa_nodes = args.numa_nodes or system_numa_nodes()
+
+    # Reference platform of the generator: 32 flops/cycle at 1 GHz, 10 GB/s local bandwidth.
+    lat_path = os.path.join(args.out_dir, "lat.txt")
+    bw_path = os.path.join(args.out_dir, "bw.txt")
+    write_matrix(lat_path, numa_nodes, 90, 140)
+    write_matrix(bw_path, numa_nodes, 10, 5)
+
+    columns = ["shape", "tasks", "edges", "scheduler", "status", "wall_time_s", "next_count", "next_p50_us",
+               "next_p99_us", "next_max_us", "peak_rss_kb", "makespan_us"]
+
+    with open(csv_path, "w", newline="") as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow(columns)
+        print(",".join(columns), flush=True)
+
+        for shape in args.shapes.split(","):
+            for size in (int(s) for s in args.sizes.split(",")):
+                width, depth = shape_dimensions(shape, size)
+                name = f"{shape}_{size}"
+                dot_path = os.path.join(args.out_dir, f"{name}.dot")
+
+                generator_args = dag_generator.parse_args([
+                    "--shape", shape, "--width", str(width), "--depth", str(depth), "--ccr", str(args.ccr),
+                    "--flops-dist", args.flops_dist, "--payload-dist", args.payload_dist, "--seed", str(args.seed),
+                    "--ref-flops-per-s", "32e9", "--ref-bandwidth-bps", "10e9"])
+                wf, flops, payloads = dag_generator.generate(generator_args)
+                with open(dot_path, "w") as dot:
+                    dag_generator.write_dot(wf, flops, payloads, dot, shape.replace("-", "_"))
+
+                for scheduler in args.schedulers.split(","):
+                    config_path = os.path.join(args.out_dir, f"{name}_{scheduler}.json")
+                    out_path = os.path.join(args.out_dir, f"{name}_{scheduler}.yaml")
+
+                    config = {
+                        "dag_file": dot_path,
+                        "scheduler_type": scheduler,
+                        "scheduler_params": [],
+                        "mapper_type": "simulation",
+                        "mapper_mem_policy_type": "default",
+                        "mapper_mem_bind_numa_node_ids": [],
+                        "core_avail_mask": "",
+                        "core_avail_ids": list(range(cores)),
+                        "flops_per_cycle": 32,
+                        "clock_frequency_type": "static",
+                        "clock_frequency_hz": 1000000000,
+                        "distance_matrices": {"latency_ns": lat_path, "bandwidth_gbps": bw_path},
+                        "trace_backend": "binary",
+                        "out_file_name": out_path,
+                    }
+                    with open(config_path, "w") as config_file:
+                        json.dump(config, config_file, indent=4)
+
+                    if os.path.exists(out_path):
+                        os.remove(out_path)
+
+                    status, wall_time_s, peak_rss_kb = run(args.nflows, config_path, args.timeout)
+                    results = read_results(out_path) if status == "ok" else ("",) * 5
+
+                    row = [shape, len(wf.tasks), len(wf.edges), scheduler, status, f"{wall_time_s:.3f}",
+                           results[0], results[1], results[2], results[3], peak_rss_kb, results[4]]
+                    writer.writerow(row)
+                    csv_file.flush()
+                    print(",".join(str(value) for value in row), flush=True)
+
+    print(f"Results: {csv_path}", file=sys.stderr)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+
+"""
+Generates synthetic workflows (DOT, as read by common_dag_read_from_dot) with a parameterized shape.
+
+Shapes (width W, depth D):
+- layered: D layers of about W tasks; each task depends on 1..max_parents random tasks of the previous layer.
+- fork-join: D stages; a fork task fans out to W tasks that join into the fork task of the next stage.
+- montage: Montage-like mosaic (mProject, mDiffFit, mConcatFit, mBgModel, mBackground, mImgtbl, mAdd, mShrink, mJPEG);
+  W images, D is ignored.
+- epigenomics: Epigenomics-like (fastQSplit, W lanes of filterContams, sol2sanger, fast2bfq, map, then mapMerge,
+  maqIndex, pileup); D is ignored.
+- in-tree: complete tree of depth D and fan-in W (leaves first).
+- out-tree: complete tree of depth D and fan-out W (root first).
+- stencil: W x D grid; task (i, t) depends on (i - 1, t - 1), (i, t - 1) and (i + 1, t - 1).
+
+Task flops and edge payloads follow a distribution (constant, uniform or lognormal) with a given mean and
+coefficient of variation. Unless --payload-mean is given, the mean payload is set from the communication to
+computation ratio (CCR) on a reference platform:
+    ccr = (payload_mean / ref_bandwidth_bps) / (flops_mean / ref_flops_per_s)
+"""
+
+import argparse
+import math
+import random
+import sys
+
+SHAPES = ["layered", "fork-join", "montage", "epigenomics", "in-tree", "out-tree", "stencil"]
+DISTRIBUTIONS = ["constant", "uniform", "lognormal"]
+
+class Workflow:
+    def __init__(self):
+        self.tasks = []   # Names, in creation order.
+        self.edges = []   # (src_index, dst_index).
+
+    def add_task(self, name):
+        self.tasks.append(name)
+        return len(self.tasks) - 1
+
+    def add_edge(self, src, dst):
+        self.edges.append((src, dst))
+
+def layered(wf, width, depth, rng, max_parents):
+    previous = []
+    for level in range(depth):
+        current = [wf.add_task(f"L{level}_{i}") for i in range(max(1, rng.randint(width // 2, width + width // 2)))]
+        for task in current:
+            for parent in (rng.sample(previous, min(len(previous), rng.randint(1, max_parents))) if previous else []):
+                wf.add_edge(parent, task)
+        previous = current
+
+def fork_join(wf, width, depth, rng, max_parents):
+    fork = wf.add_task("fork_0")
+    for stage in range(depth):
+        branches = [wf.add_task(f"branch_{stage}_{i}") for i in range(width)]
+        join = wf.add_task(f"fork_{stage + 1}")
+        for branch in branches:
+            wf.add_edge(fork, branch)
+            wf.add_edge(branch, join)
+        fork = join
+
+def montage(wf, width, depth, rng, max_parents):
+    projects = [wf.add_task(f"mProject_{i}") for i in range(width)]
+    diff_fits = []
+    for i in range(width - 1):
+        # Overlapping images: each image overlaps with the next one (and, sometimes, the one after).
+        for j in ([i + 1, i + 2] if i + 2 < width and rng.random() < 0.5 else [i + 1]):
+            diff_fit = wf.add_task(f"mDiffFit_{i}_{j}")
+            wf.add_edge(projects[i], diff_fit)
+            wf.add_edge(projects[j], diff_fit)
+            diff_fits.append(diff_fit)
+
+    concat_fit = wf.add_task("mConcatFit")
+    for diff_fit in diff_fits:
+        wf.add_edge(diff_fit, concat_fit)
+    bg_model = wf.add_task("mBgModel")
+    wf.add_edge(concat_fit, bg_model)
+
+    imgtbl = wf.add_task("mImgtbl")
+    add = wf.add_task("mAdd")
+    for i, project in enumerate(projects):
+        background = wf.add_task(f"mBackground_{i}")
+        wf.add_edge(project, background)
+        wf.add_edge(bg_model, background)
+        wf.add_edge(background, imgtbl)
+        wf.add_edge(background, add)
+    wf.add_edge(imgtbl, add)
+
+    shrink = wf.add_task("mShrink")
+    wf.add_edge(add, shrink)
+    jpeg = wf.add_task("mJPEG")
+    wf.add_edge(shrink, jpeg)
+
+def epigenomics(wf, width, depth, rng, max_parents):
+    split = wf.add_task("fastQSplit")
+    merge = wf.add_task("mapMerge")
+    for i in range(width):
+        previous = split
+        for stage in ["filterContams", "sol2sanger", "fast2bfq", "map"]:
+            task = wf.add_task(f"{stage}_{i}")
+            wf.add_edge(previous, task)
+            previous = task
+        wf.add_edge(previous, merge)
+
+    index = wf.add_task("maqIndex")
+    wf.add_edge(merge, index)
+    pileup = wf.add_task("pileup")
+    wf.add_edge(index, pileup)
+
+def out_tree(wf, width, depth, rng, max_parents, reverse=False):
+    level = [wf.add_task("tree_0_0")]
+    for d in range(1, depth):
+        children = []
+        for parent in level:
+            for _ in range(width):
+                child = wf.add_task(f"tree_{d}_{len(children)}")
+                if reverse:
+                    wf.add_edge(child, parent)
+                else:
+                    wf.add_edge(parent, child)
+                children.append(child)
+        level = children
+
+def in_tree(wf, width, depth, rng, max_parents):
+    out_tree(wf, width, depth, rng, max_parents, reverse=True)
+
+def stencil(wf, width, depth, rng, max_parents):
+    previous = []
+    for t in range(depth):
+        current = [wf.add_task(f"cell_{t}_{i}") for i in range(width)]
+        for i, task in enumerate(current):
+            for j in (i - 1, i, i + 1):
+                if 0 <= j < len(previous):
+                    wf.add_edge(previous[j], task)
+        previous = current
+
+GENERATORS = {
+    "layered": layered,
+    "fork-join": fork_join,
+    "montage": montage,
+    "epigenomics": epigenomics,
+    "in-tree": in_tree,
+    "out-tree": out_tree,
+    "stencil": stencil,
+}
+
+def sample(rng, distribution, mean, cv):
+    """Positive sample with the given mean and coefficient of variation (rounded to an integer >= 1)."""
+    if distribution == "constant" or cv == 0:
+        value = mean
+    elif distribution == "uniform":
+        # Uniform on [mean - a, mean + a] has cv = a / (mean * sqrt(3)); clamped to stay positive.
+        half_range = min(mean * cv * math.sqrt(3), mean)
+        value = rng.uniform(mean - half_range, mean + half_range)
+    else:
+        sigma = math.sqrt(math.log(1 + cv * cv))
+        value = rng.lognormvariate(math.log(mean) - sigma * sigma / 2, sigma)
+    return max(1, int(round(value)))
+
+def generate(args):
+    rng = random.Random(args.seed)
+    wf = Workflow()
+    GENERATORS[args.shape](wf, args.width, args.depth, rng, args.max_parents)
+
+    payload_mean = args.payload_mean
+    if payload_mean is None:
+        payload_mean = args.ccr * args.flops_mean / args.ref_flops_per_s * args.ref_bandwidth_bps
+
+    flops = [sample(rng, args.flops_dist, args.flops_mean, args.flops_cv) for _ in wf.tasks]
+    payloads = [sample(rng, args.payload_dist, payload_mean, args.payload_cv) for _ in wf.edges]
+    return wf, flops, payloads
+
+def write_dot(wf, flops, payloads, out, name):
+    has_parent = [False] * len(wf.tasks)
+    has_child = [False] * len(wf.tasks)
+    for src, dst in wf.edges:
+        has_child[src] = True
+        has_parent[dst] = True
+
+    out.write(f"digraph {name} {{\n")
+    out.write("    root [size=2]; // Ignored in processing.\n")
+    out.write("    end  [size=2]; // Ignored in processing.\n\n")
+
+    for task, task_flops in zip(wf.tasks, flops):
+        out.write(f"    {task} [size={task_flops}];\n")
+    out.write("\n")
+
+    for task, parent in zip(wf.tasks, has_parent):
+        if not parent:
+            out.write(f"    root -> {task} [size=2];\n")
+
+    for (src, dst), payload in zip(wf.edges, payloads):
+        out.write(f"    {wf.tasks[src]} -> {wf.tasks[dst]} [size={payload}];\n")
+
+    for task, child in zip(wf.tasks, has_child):
+        if not child:
+            out.write(f"    {task} -> end [size=2];\n")
+    out.write("}\n")
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(description="Generate a synthetic nflows workflow (DOT).")
+    parser.add_argument("--shape", choices=SHAPES, default="layered")
+    parser.add_argument("--width", type=int, default=10, help="Tasks per level / images / lanes / tree arity")
+    parser.add_argument("--depth", type=int, default=10, help="Levels / stages / tree depth / time steps")
+    parser.add_argument("--max-parents", type=int, default=3, help="Parents per task (layered)")
+    parser.add_argument("--flops-mean", type=float, default=1e9)
+    parser.add_argument("--flops-dist", choices=DISTRIBUTIONS, default="constant")
+    parser.add_argument("--flops-cv", type=float, default=0.5, help="Coefficient of variation of the flops")
+    parser.add_argument("--ccr", type=float, default=1.0, help="Communication to computation ratio")
+    parser.add_argument("--payload-mean", type=float, default=None, help="Mean payload (bytes); overrides --ccr")
+    parser.add_argument("--payload-dist", choices=DISTRIBUTIONS, default="constant")
+    parser.add_argument("--payload-cv", type=float, default=0.5, help="Coefficient of variation of the payloads")
+    parser.add_argument("--ref-flops-per-s", type=float, default=32e9, help="Reference core speed (CCR)")
+    parser.add_argument("--ref-bandwidth-bps", type=float, default=10e9, help="Reference bandwidth (CCR)")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("-o", "--output", metavar="DOT", help="Output file (default: stdout)")
+    return parser.parse_args(argv)
+
+if __name__ == "__main__":
+    args = parse_args()
+    if args.width < 1 or args.depth < 1:
+        sys.exit("--width and --depth must be >= 1.")
+
+    wf, flops, payloads = generate(args)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    write_dot(wf, flops, payloads, out, args.shape.replace("-", "_"))
+    if args.output:
+        out.close()
+
+    print(f"{args.shape}: {len(wf.tasks)} tasks, {len(wf.edges)} edges", file=sys.stderr)
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+
+"""
+Converts a binary trace (trace_backend: binary) to the trace section of the yaml backend,
+so the result can be checked with validators/validate_offsets.py and validate_output.py.
+
+The layout is described in include/trace.hpp.
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER = struct.Struct("<8sIIQQIII20x")
+RECORD = struct.Struct("<BBHIdddQii")
+MAGIC = b"NFLOWTRC"
+VERSION = 1
+
+PHASES = ["read", "compute", "write"]
+
+# Record types (TraceRecordType) in output order.
+(THREAD_LOCALITY, PERF_COUNTER, NUMA_WRITE, NUMA_READ,
+ READ_TIMESTAMP, WRITE_TIMESTAMP, COMPUTE_TIMESTAMP,
+ READ_OFFSET, WRITE_OFFSET, MIGRATION_OFFSET, COMPUTE_OFFSET, TOTAL_OFFSET) = range(12)
+
+TIME_RANGE_TABLES = [
+    (NUMA_WRITE, "comms", "numa_mappings_write"),
+    (NUMA_READ, "comms", "numa_mappings_read"),
+    (READ_TIMESTAMP, "comms", "comm_name_read_timestamps"),
+    (WRITE_TIMESTAMP, "comms", "comm_name_write_timestamps"),
+    (COMPUTE_TIMESTAMP, "execs", "exec_name_compute_timestamps"),
+    (READ_OFFSET, "comms", "comm_name_read_offsets"),
+    (WRITE_OFFSET, "comms", "comm_name_write_offsets"),
+    (MIGRATION_OFFSET, "comms", "comm_name_migration_offsets"),
+    (COMPUTE_OFFSET, "execs", "exec_name_compute_offsets"),
+    (TOTAL_OFFSET, "execs", "exec_name_total_offsets"),
+]
+
+def fmt(value):
+    """Formats a double as std::ostream does with the default precision."""
+    return "%g" % value
+
+def read_trace(file_path):
+    """Returns (names, tables); tables maps a record type to {id: record}."""
+    with open(file_path, "rb") as file:
+        data = file.read()
+
+    magic, version, record_bytes, records_count, strings_offset, execs_count, comms_count, counters_count = \
+        HEADER.unpack_from(data, 0)
+
+    if magic != MAGIC or version != VERSION or record_bytes != RECORD.size:
+        sys.exit(f"{file_path}: not a version {VERSION} nflows trace.")
+    if strings_offset == 0:
+        sys.exit(f"{file_path}: incomplete trace (the run did not finish).")
+
+    offset = strings_offset
+    strings = []
+    for _ in range(execs_count + comms_count + counters_count + 1):
+        (length,) = struct.unpack_from("<I", data, offset)
+        strings.append(data[offset + 4:offset + 4 + length].decode())
+        offset += 4 + length
+
+    names = {
+        "execs": strings[:execs_count],
+        "comms": strings[execs_count:execs_count + comms_count],
+        "counters": strings[execs_count + comms_count:-1],
+        "counters_source": strings[-1],
+    }
+
+    tables = {}
+    for index in range(records_count):
+        record = RECORD.unpack_from(data, HEADER.size + index * RECORD.size)
+        record_type, phase, counter, record_id = record[:4]
+
+        if record_type == PERF_COUNTER:
+            values = tables.setdefault(PERF_COUNTER, {}).setdefault(record_id, [[0] * counters_count for _ in PHASES])
+            values[phase][counter] = record[6]
+        else:
+            tables.setdefault(record_type, {})[record_id] = record
+
+    return names, tables
+
+def write_trace(names, tables, out):
+    out.write("trace:\n")
+
+    mapping = tables.get(THREAD_LOCALITY, {})
+    if mapping:
+        out.write("  name_to_thread_locality:\n")
+        for record_id in sorted(mapping):
+            _, _, _, _, voluntary_cs, involuntary_cs, core_migrations, _, core_id, numa_id = mapping[record_id]
+            out.write(f"    {names['execs'][record_id]}: {{numa_id: {numa_id}, core_id: {core_id}, "
+                      f"voluntary_cs: {int(voluntary_cs)}, involuntary_cs: {int(involuntary_cs)}, "
+                      f"core_migrations: {int(core_migrations)}}}\n")
+        out.write("\n")
+
+    mapping = tables.get(PERF_COUNTER, {})
+    if mapping:
+        out.write(f"  perf_counters_source: {names['counters_source']}\n")
+        out.write("  exec_name_perf_counters:\n")
+        for record_id in sorted(mapping):
+            phases = ", ".join(
+                f"{phase}: {{" + ", ".join(f"{name}: {int(value)}" for name, value in zip(names["counters"], values)) + "}"
+                for phase, values in zip(PHASES, mapping[record_id]))
+            out.write(f"    {names['execs'][record_id]}: {{{phases}}}\n")
+        out.write("\n")
+
+    for record_type, kind, header in TIME_RANGE_TABLES:
+        mapping = tables.get(record_type, {})
+        if not mapping:
+            continue
+
+        out.write(f"  {header}:\n")
+        for record_id in sorted(mapping):
+            _, _, _, _, start, end, payload, numa_mask, _, _ = mapping[record_id]
+            name = names[kind][record_id]
+
+            if record_type in (NUMA_WRITE, NUMA_READ):
+                numa_ids = ", ".join(str(i) for i in range(64) if numa_mask >> i & 1)
+                out.write(f"    {name}: {{numa_ids: [{numa_ids}]}}\n")
+            else:
+                out.write(f"    {name}: {{start: {fmt(start)}, end: {fmt(end)}, payload: {fmt(payload)}}}\n")
+        out.write("\n")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert an nflows binary trace to the yaml trace layout.")
+    parser.add_argument("--base", metavar="YAML", help="nflows output file to prepend (written without a trace section)")
+    parser.add_argument("-o", "--output", metavar="YAML", help="Output file (default: stdout)")
+    parser.add_argument("trace_file", help="Path to the binary trace file")
+    args = parser.parse_args()
+
+    names, tables = read_trace(args.trace_file)
+
+    base = ""
+    if args.base:
+        with open(args.base, "r") as file:
+            base = file.read()
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    out.write(base)
+    write_trace(names, tables, out)
+    if args.output:
+        out.close()
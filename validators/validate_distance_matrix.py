@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+
+"""
+Checks that distance matrix files (distance_matrices, nflows --calibrate) are in the text format:
+the first line is the number of NUMA nodes N, followed by N rows of N positive values.
+All the files must have the same N.
+"""
+
+import sys
+import argparse
+
+def read_matrix_size(matrix_path):
+    """Returns N if the file is a valid N x N matrix, None otherwise."""
+    with open(matrix_path, "r") as file:
+        lines = [line.split() for line in file.read().splitlines() if line.strip()]
+
+    if not lines or len(lines[0]) != 1 or not lines[0][0].isdigit() or int(lines[0][0]) < 1:
+        print(f"'{matrix_path}': the first line is not the number of NUMA nodes")
+        return None
+
+    n = int(lines[0][0])
+    rows = lines[1:]
+    if len(rows) != n or any(len(row) != n for row in rows):
+        print(f"'{matrix_path}': expected {n} rows of {n} values, got {[len(row) for row in rows]}")
+        return None
+
+    try:
+        values = [float(value) for row in rows for value in row]
+    except ValueError as e:
+        print(f"'{matrix_path}': {e}")
+        return None
+
+    if any(value <= 0 for value in values):
+        print(f"'{matrix_path}': values must be positive")
+        return None
+
+    return n
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Validate the text format of distance matrix files.")
+    parser.add_argument("matrix_files", nargs="+", help="Paths to the distance matrix files")
+
+    args = parser.parse_args()
+
+    sizes = [read_matrix_size(matrix_file) for matrix_file in args.matrix_files]
+
+    if None not in sizes and len(set(sizes)) == 1:
+        print(f"Distance matrix validation successful: {args.matrix_files} ({sizes[0]} NUMA nodes).")
+    else:
+        if None not in sizes:
+            print(f"Matrix sizes differ: {sizes}")
+        print(f"Distance matrix validation failed: {args.matrix_files}.")
+        sys.exit(1)
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+
+"""
+Checks that a log contains the lines expected by a test.
+
+Each non-empty line of the patterns file, other than comments (#), is '<count> <regex>':
+the regex must match exactly <count> log lines, or at least one if <count> is '+'.
+"""
+
+import re
+import sys
+import argparse
+
+def load_patterns(patterns_path):
+    """Loads (count, regex) pairs from the patterns file."""
+    patterns = []
+    with open(patterns_path, "r") as file:
+        for line in file:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            count, regex = line.split(" ", 1)
+            patterns.append((None if count == "+" else int(count), re.compile(regex)))
+    return patterns
+
+def validate_log(log_path, patterns_path):
+    with open(log_path, "r") as file:
+        lines = file.read().splitlines()
+
+    valid = True
+    for count, regex in load_patterns(patterns_path):
+        matches = sum(1 for line in lines if regex.search(line))
+        if (count is None and matches == 0) or (count is not None and matches != count):
+            expected = "at least 1" if count is None else str(count)
+            print(f"Pattern '{regex.pattern}': expected {expected} matching lines, got {matches}")
+            valid = False
+    return valid
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Validate that a log contains the expected lines.")
+    parser.add_argument("log_file", help="Path to the log file")
+    parser.add_argument("patterns_file", help="Path to the patterns file")
+
+    args = parser.parse_args()
+
+    if validate_log(args.log_file, args.patterns_file):
+        print(f"Log validation successful: '{args.log_file}' matches '{args.patterns_file}'.")
+    else:
+        print(f"Log validation failed: '{args.log_file}' does not match '{args.patterns_file}'.")
+        sys.exit(1)
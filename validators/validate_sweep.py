@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+"""
+Checks the summary of a sweep (nflows --sweep) against an expected CSV.
+
+The expected CSV has the axis columns of the summary, the expected status, and an expected_file column:
+the expected output YAML of the single run with the same configuration. Each expected row must match
+exactly one summary row, with the same status and, if ok, the makespan of the single run
+(the latest end of its exec_name_total_offsets).
+"""
+
+import csv
+import sys
+import yaml
+import argparse
+
+NON_AXIS_COLUMNS = {"combination", "status", "makespan_us", "remote_bytes", "scheduling_time_us", "decisions", "expected_file"}
+
+def load_rows(csv_path):
+    with open(csv_path, "r", newline="") as file:
+        return list(csv.DictReader(file))
+
+def single_run_makespan(expected_path):
+    with open(expected_path, "r") as file:
+        offsets = yaml.safe_load(file)["trace"]["exec_name_total_offsets"]
+    return max(float(offset["end"]) for offset in offsets.values())
+
+def validate_sweep(output_path, expected_path):
+    output_rows = load_rows(output_path)
+    expected_rows = load_rows(expected_path)
+
+    valid = True
+    if len(output_rows) != len(expected_rows):
+        print(f"Expected {len(expected_rows)} combinations, got {len(output_rows)}")
+        valid = False
+
+    for expected in expected_rows:
+        axes = {key: value for key, value in expected.items() if key not in NON_AXIS_COLUMNS}
+        matches = [row for row in output_rows if all(row.get(key) == value for key, value in axes.items())]
+
+        if len(matches) != 1:
+            print(f"Combination {axes}: expected 1 row, got {len(matches)}")
+            valid = False
+            continue
+
+        row = matches[0]
+        if row["status"] != expected["status"]:
+            print(f"Combination {axes}: expected status {expected['status']}, got {row['status']}")
+            valid = False
+            continue
+
+        if row["status"] == "ok":
+            makespan_us = single_run_makespan(expected["expected_file"])
+            if abs(float(row["makespan_us"]) - makespan_us) > 1e-6 * max(1.0, makespan_us):
+                print(f"Combination {axes}: makespan_us {row['makespan_us']} != {makespan_us} ({expected['expected_file']})")
+                valid = False
+
+    return valid
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Validate a sweep summary against the expected single runs.")
+    parser.add_argument("output_csv", help="Path to the sweep summary CSV file")
+    parser.add_argument("expected_csv", help="Path to the expected CSV file")
+
+    args = parser.parse_args()
+
+    if validate_sweep(args.output_csv, args.expected_csv):
+        print(f"Sweep validation successful: '{args.output_csv}' matches '{args.expected_csv}'.")
+    else:
+        print(f"Sweep validation failed: '{args.output_csv}' does not match '{args.expected_csv}'.")
+        sys.exit(1)
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+"""
+Checks a timeline (Chrome Trace Event JSON, timeline_file_name) against the output YAML of the same run:
+- one process per NUMA node and one track per core, covering the NUMA node and core of every task;
+- an X slice per read, compute and write offset, on the track of the task and with the same times;
+- a matching s/f flow pair per comm, from the start of its write to the start of its read.
+"""
+
+import sys
+import json
+import yaml
+import argparse
+
+SLICE_SECTIONS = {
+    "read": "comm_name_read_offsets",
+    "write": "comm_name_write_offsets",
+    "compute": "exec_name_compute_offsets",
+}
+
+def same_time(a, b):
+    """Offsets are printed with 6 significant digits in the YAML, and 3 decimals in the timeline."""
+    return abs(float(a) - float(b)) <= max(1e-3, 1e-5 * abs(float(b)))
+
+def slice_task(category, name):
+    """Task owning the slice: the reader of a read, the writer of a write, the task itself for a compute."""
+    if category == "compute":
+        return name
+    src, dst = name.split("->")
+    return dst if category == "read" else src
+
+def validate_timeline(timeline_path, output_path):
+    with open(timeline_path, "r") as file:
+        events = json.load(file)["traceEvents"]
+    with open(output_path, "r") as file:
+        trace = yaml.safe_load(file)["trace"]
+
+    errors = []
+    locality = trace.get("name_to_thread_locality") or {}
+
+    # Processes (NUMA nodes) and tracks (cores).
+    process_names = {}
+    track_pids = {}
+    for event in events:
+        if event["ph"] != "M":
+            continue
+        if event["name"] == "process_name":
+            process_names.setdefault(event["pid"], set()).add(event["args"]["name"])
+        elif event["name"] == "thread_name":
+            if event["tid"] in track_pids:
+                errors.append(f"Core {event['tid']} has more than one track")
+            track_pids[event["tid"]] = event["pid"]
+            if event["args"]["name"] != f"core {event['tid']}":
+                errors.append(f"Track {event['tid']} is named '{event['args']['name']}'")
+
+    for pid, names in process_names.items():
+        if names != {f"numa {pid}"}:
+            errors.append(f"Process {pid} is named {sorted(names)}")
+    for tid, pid in track_pids.items():
+        if pid not in process_names:
+            errors.append(f"Track of core {tid} belongs to an unnamed process {pid}")
+
+    for task, thread in locality.items():
+        if track_pids.get(thread["core_id"]) != thread["numa_id"]:
+            errors.append(f"{task}: no track for core {thread['core_id']} in the process of numa {thread['numa_id']}")
+
+    def on_task_track(event, task):
+        thread = locality.get(task)
+        return thread is not None and event["pid"] == thread["numa_id"] and event["tid"] == thread["core_id"]
+
+    # One X slice per offset.
+    for category, section in SLICE_SECTIONS.items():
+        offsets = trace.get(section) or {}
+        slices = [event for event in events if event["ph"] == "X" and event["cat"] == category]
+
+        if len(slices) != len(offsets):
+            errors.append(f"{len(slices)} {category} slices for {len(offsets)} {section}")
+
+        for name, offset in offsets.items():
+            matches = [event for event in slices if event["name"] == name]
+            if len(matches) != 1:
+                errors.append(f"{category} {name}: expected 1 slice, got {len(matches)}")
+                continue
+            event = matches[0]
+            if not on_task_track(event, slice_task(category, name)):
+                errors.append(f"{category} {name}: slice on the track of core {event['tid']} (numa {event['pid']})")
+            if not same_time(event["ts"], offset["start"]) or not same_time(event["ts"] + event["dur"], offset["end"]):
+                errors.append(f"{category} {name}: slice [{event['ts']}, {event['ts'] + event['dur']}] != offset [{offset['start']}, {offset['end']}]")
+
+    # One s/f flow pair per comm.
+    writes = trace.get("comm_name_write_offsets") or {}
+    reads = trace.get("comm_name_read_offsets") or {}
+    flows = {}
+    for event in events:
+        if event["ph"] in ("s", "f"):
+            flows.setdefault(event["id"], []).append(event)
+
+    if len(flows) != len(writes):
+        errors.append(f"{len(flows)} flows for {len(writes)} comms")
+
+    for flow_id, flow in flows.items():
+        phases = sorted(event["ph"] for event in flow)
+        names = {event["name"] for event in flow}
+        if phases != ["f", "s"] or len(names) != 1:
+            errors.append(f"Flow {flow_id}: expected one s and one f event of the same comm, got {phases} for {sorted(names)}")
+            continue
+
+        name = names.pop()
+        start = next(event for event in flow if event["ph"] == "s")
+        end = next(event for event in flow if event["ph"] == "f")
+
+        if name not in writes or name not in reads:
+            errors.append(f"Flow {flow_id}: comm {name} has no write or read offset")
+            continue
+        if not on_task_track(start, slice_task("write", name)) or not same_time(start["ts"], writes[name]["start"]):
+            errors.append(f"Flow {flow_id} ({name}): does not start at its write")
+        if not on_task_track(end, slice_task("read", name)) or not same_time(end["ts"], reads[name]["start"]):
+            errors.append(f"Flow {flow_id} ({name}): does not end at its read")
+
+    for error in errors:
+        print(error)
+    return not errors
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Validate a timeline against the output YAML of the same run.")
+    parser.add_argument("timeline_json", help="Path to the timeline JSON file")
+    parser.add_argument("output_yaml", help="Path to the output YAML file")
+
+    args = parser.parse_args()
+
+    if validate_timeline(args.timeline_json, args.output_yaml):
+        print(f"Timeline validation successful: '{args.timeline_json}' matches '{args.output_yaml}'.")
+    else:
+        print(f"Timeline validation failed: '{args.timeline_json}' does not match '{args.output_yaml}'.")
+        sys.exit(1)